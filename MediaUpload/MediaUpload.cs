@@ -1,6 +1,7 @@
 ﻿using SwitcherLib;
 using System;
 using System.Collections.Generic;
+using System.Linq;
 using System.Threading;
 
 namespace MediaUpload
@@ -26,11 +27,13 @@ namespace MediaUpload
             ConsoleUtils.Version();
             Console.Out.WriteLine();
             Console.Out.WriteLine("Usage: mediaupload [options] <hostname> <slot> <filename>");
+            Console.Out.WriteLine("       mediaupload [options] --render <directory> <hostname> <filename>...");
+            Console.Out.WriteLine("       mediaupload [options] --render <directory> --size <width>x<height> <filename>...");
             Console.Out.WriteLine("Uploads an image to a BlackMagic ATEM switcher");
             Console.Out.WriteLine();
             Console.Out.WriteLine("Arguments:");
             Console.Out.WriteLine();
-            Console.Out.WriteLine(" hostname        - The hostname or IP of the ATEM switcher");
+            Console.Out.WriteLine(" hostname        - The hostname or IP of the ATEM switcher, or a comma-separated list to upload to several at once");
             Console.Out.WriteLine(" slot            - The number of the media slot to upload to");
             Console.Out.WriteLine(" filename        - The filename of the image to upload");
             Console.Out.WriteLine();
@@ -40,16 +43,28 @@ namespace MediaUpload
             Console.Out.WriteLine(" -d, --debug     - Debug output");
             Console.Out.WriteLine(" -v, --version   - Version information");
             Console.Out.WriteLine(" -n, --name      - The name for the item in the media pool");
+            Console.Out.WriteLine(" -r, --render    - Render the images into frame files in a directory instead of uploading");
+            Console.Out.WriteLine(" -s, --size      - The resolution to render for, e.g. 1920x1080. Without it --render connects to <hostname> to find out");
+            Console.Out.WriteLine(" -a, --alpha     - Alpha handling: straight (default), premultiply, unpremultiply or opaque");
+            Console.Out.WriteLine(" -k, --key       - Also upload the alpha channel as a luma key to this slot, with a premultiplied fill in <slot>. Needs straight alpha, so it cannot be combined with --alpha");
             Console.Out.WriteLine();
             Console.Out.WriteLine("Image Format:");
             Console.Out.WriteLine();
             Console.Out.WriteLine("The image must be the same resolution as the switcher. Accepted formats are BMP, JPEG, GIF, PNG and TIFF. Alpha channels are supported.");
+            Console.Out.WriteLine();
+            Console.Out.WriteLine("Frame files (" + FrameCache.Extension + ") made with --render are uploaded without decoding. The upload is skipped if the slot's hash shows it already holds the frame, which depends on how the switcher hashes stills.");
+            Console.Out.WriteLine();
+            Console.Out.WriteLine("When several switchers are given the image is decoded and converted once and uploaded to all of them in parallel. Switchers whose resolution does not match the image are reported as failed. Frame files cannot be uploaded to several switchers.");
         }
 
         private static void ProcessArgs(string[] args)
         {
             IList<string> args1 = new List<string>();
             string name = "";
+            string renderDirectory = "";
+            string renderSize = "";
+            AlphaMode alphaMode = AlphaMode.Straight;
+            int keySlot = -1;
             for (int index = 0; index < args.Length; index++)
             {
                 switch (args[index])
@@ -89,15 +104,103 @@ namespace MediaUpload
                         }
                         break;
 
+                    case "-r":
+                    case "--render":
+                    case "/r":
+                    case "/render":
+                        if (index + 1 < args.Length)
+                        {
+                            renderDirectory = args[index + 1];
+                            index++;
+                            break;
+                        }
+                        break;
+
+                    case "-s":
+                    case "--size":
+                    case "/s":
+                    case "/size":
+                        if (index + 1 < args.Length)
+                        {
+                            renderSize = args[index + 1];
+                            index++;
+                            break;
+                        }
+                        break;
+
+                    case "-a":
+                    case "--alpha":
+                    case "/a":
+                    case "/alpha":
+                        if (index + 1 < args.Length)
+                        {
+                            alphaMode = MediaUpload.GetAlphaMode(args[index + 1]);
+                            index++;
+                            break;
+                        }
+                        break;
+
+                    case "-k":
+                    case "--key":
+                    case "/k":
+                    case "/key":
+                        if (index + 1 < args.Length)
+                        {
+                            keySlot = MediaUpload.GetSlot(args[index + 1]);
+                            index++;
+                            break;
+                        }
+                        break;
+
                     default:
                         args1.Add(args[index]);
                         break;
                 }
             }
-            MediaUpload.Upload(name, args1);
+
+            if (renderDirectory != "")
+            {
+                MediaUpload.Render(renderDirectory, renderSize, args1);
+                return;
+            }
+            MediaUpload.Upload(name, alphaMode, keySlot, args1);
         }
 
-        private static void Upload(string name, IList<string> args)
+        private static void Render(string directory, string size, IList<string> args)
+        {
+            if (args.Count < (size != "" ? 1 : 2))
+            {
+                MediaUpload.Help();
+                throw new SwitcherLibException("Invalid arguments");
+            }
+
+            int width;
+            int height;
+            int videoMode;
+            if (size != "")
+            {
+                (width, height) = MediaUpload.GetSize(size);
+                videoMode = FrameCache.UnknownVideoMode;
+            }
+            else
+            {
+                Switcher switcher = new Switcher(args[0]);
+                width = switcher.GetVideoWidth();
+                height = switcher.GetVideoHeight();
+                videoMode = switcher.GetVideoMode();
+                Log.Debug(String.Format("Switcher: {0}", switcher.GetProductName()));
+                args.RemoveAt(0);
+            }
+            Log.Debug(String.Format("Resolution: {0}x{1}", width.ToString(), height.ToString()));
+
+            IList<string> outputs = FrameCache.RenderAll(args, directory, width, height, videoMode);
+            foreach (string output in outputs)
+            {
+                Log.Info(String.Format("Rendered: {0}", output));
+            }
+        }
+
+        private static void Upload(string name, AlphaMode alphaMode, int keySlot, IList<string> args)
         {
             if (args.Count < 3)
             {
@@ -105,7 +208,33 @@ namespace MediaUpload
                 throw new SwitcherLibException("Invalid arguments");
             }
 
-            Switcher switcher = new Switcher(args[0]);
+            if (keySlot >= 0 && alphaMode != AlphaMode.Straight)
+            {
+                throw new SwitcherLibException("--alpha cannot be combined with --key, the fill/key split expects straight alpha");
+            }
+
+            // Two connections to one switcher would race for its media pool lock.
+            string[] hostnames = args[0].Split(new[] { ',' }, StringSplitOptions.RemoveEmptyEntries)
+                .Select(hostname => hostname.Trim())
+                .Where(hostname => hostname != "")
+                .Distinct(StringComparer.OrdinalIgnoreCase)
+                .ToArray();
+            if (hostnames.Length == 0)
+            {
+                MediaUpload.Help();
+                throw new SwitcherLibException("Invalid arguments");
+            }
+            if (hostnames.Length > 1)
+            {
+                if (alphaMode != AlphaMode.Straight || keySlot >= 0)
+                {
+                    throw new SwitcherLibException("--alpha and --key are not supported when uploading to several switchers");
+                }
+                MediaUpload.FanOut(name, hostnames, args);
+                return;
+            }
+
+            Switcher switcher = new Switcher(hostnames[0]);
             int slot = MediaUpload.GetSlot(args[1]);
             Log.Debug(String.Format("Switcher: {0}", switcher.GetProductName()));
             Log.Debug(String.Format("Resolution: {0}x{1}", switcher.GetVideoWidth().ToString(), switcher.GetVideoHeight().ToString()));
@@ -118,7 +247,16 @@ namespace MediaUpload
             {
                 upload.SetName(name);
             }
+            upload.SetAlphaMode(alphaMode);
+            if (keySlot >= 0)
+            {
+                upload.SetKeySlot(keySlot);
+            }
             upload.Start();
+            if (upload.WasSkipped())
+            {
+                Log.Info("Slot already contains this frame, skipped upload");
+            }
             while (upload.InProgress())
             {
                 Log.Info(String.Format("Progress: {0}%", upload.GetProgress().ToString()));
@@ -126,16 +264,102 @@ namespace MediaUpload
             }
         }
 
+        private static void FanOut(string name, string[] hostnames, IList<string> args)
+        {
+            int slot = MediaUpload.GetSlot(args[1]);
+            args.RemoveAt(0);
+            args.RemoveAt(0);
+
+            string filename = String.Join(" ", args);
+            List<Switcher> switchers = new List<Switcher>();
+            foreach (string hostname in hostnames)
+            {
+                switchers.Add(new Switcher(hostname.Trim()));
+            }
+
+            try
+            {
+                FanOutUpload upload = new FanOutUpload(switchers, filename, slot);
+                if (name != "")
+                {
+                    upload.SetName(name);
+                }
+
+                int failed = 0;
+                foreach (FanOutResult result in upload.Start())
+                {
+                    if (result.Success)
+                    {
+                        Log.Info(String.Format("{0}: OK ({1}x{2}, {3} ms)", result.Address, result.Width.ToString(), result.Height.ToString(), result.LatencyMs.ToString("0")));
+                    }
+                    else
+                    {
+                        Log.Error(String.Format("{0}: FAILED ({1})", result.Address, result.Error));
+                        failed++;
+                    }
+                }
+
+                if (failed > 0)
+                {
+                    throw new SwitcherLibException(String.Format("Upload failed on {0} of {1} switchers", failed.ToString(), hostnames.Length.ToString()));
+                }
+            }
+            finally
+            {
+                foreach (Switcher switcher in switchers)
+                {
+                    switcher.Dispose();
+                }
+            }
+        }
+
+        private static AlphaMode GetAlphaMode(string arg)
+        {
+            switch (arg.ToLower())
+            {
+                case "straight":
+                    return AlphaMode.Straight;
+                case "premultiply":
+                    return AlphaMode.Premultiply;
+                case "unpremultiply":
+                    return AlphaMode.Unpremultiply;
+                case "opaque":
+                    return AlphaMode.Opaque;
+                default:
+                    throw new SwitcherLibException(String.Format("Unknown alpha mode: {0}", arg));
+            }
+        }
+
+        private static (int width, int height) GetSize(string arg)
+        {
+            string[] parts = arg.ToLower().Split('x');
+            if (parts.Length == 2 && int.TryParse(parts[0], out int width) && int.TryParse(parts[1], out int height) && width > 0 && height > 0)
+            {
+                return (width, height);
+            }
+
+            throw new SwitcherLibException(String.Format("Invalid size: {0}", arg));
+        }
+
         private static int GetSlot(string arg)
         {
+            int slot;
             try
             {
-                return Convert.ToInt32(arg) - 1;
+                slot = Convert.ToInt32(arg);
             }
             catch (Exception ex)
             {
                 throw new SwitcherLibException(String.Format("Invalid slot: {0}", arg), ex);
             }
+
+            // Slots are numbered from 1.
+            if (slot < 1)
+            {
+                throw new SwitcherLibException(String.Format("Invalid slot: {0}", arg));
+            }
+
+            return slot - 1;
         }
     }
 }
@@ -0,0 +1,51 @@
+using System.IO;
+using BenchmarkDotNet.Attributes;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SwitcherLib.Benchmarks
+{
+    public class ConvertImageBenchmarks
+    {
+        private Image<Rgba32> image;
+        private string filename;
+
+        [Params(FrameSize.SD, FrameSize.HD720, FrameSize.HD1080, FrameSize.UHD4K)]
+        public FrameSize Size;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            this.image = new Image<Rgba32>(this.Size.Width(), this.Size.Height());
+            for (int y = 0; y < this.image.Height; y++)
+            {
+                for (int x = 0; x < this.image.Width; x++)
+                {
+                    this.image[x, y] = new Rgba32((byte)x, (byte)y, (byte)(x + y), (byte)(x ^ y));
+                }
+            }
+
+            this.filename = Path.Combine(Path.GetTempPath(), string.Format("switcherlib-bench-{0}.png", this.Size));
+            this.image.SaveAsPng(this.filename);
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            this.image.Dispose();
+            File.Delete(this.filename);
+        }
+
+        [Benchmark]
+        public byte[] ConvertPixels()
+        {
+            return Upload.ConvertPixels(this.image);
+        }
+
+        [Benchmark]
+        public byte[] ConvertImage()
+        {
+            return Upload.ConvertImage(this.filename, this.Size.Width(), this.Size.Height());
+        }
+    }
+}
@@ -0,0 +1,54 @@
+using System;
+
+namespace SwitcherLib.Benchmarks
+{
+    public enum FrameSize
+    {
+        SD,
+        HD720,
+        HD1080,
+        UHD4K,
+    }
+
+    public static class FrameSizeExtensions
+    {
+        public static int Width(this FrameSize size)
+        {
+            switch (size)
+            {
+                case FrameSize.SD:
+                    return 720;
+                case FrameSize.HD720:
+                    return 1280;
+                case FrameSize.HD1080:
+                    return 1920;
+                case FrameSize.UHD4K:
+                    return 3840;
+                default:
+                    throw new ArgumentOutOfRangeException(nameof(size));
+            }
+        }
+
+        public static int Height(this FrameSize size)
+        {
+            switch (size)
+            {
+                case FrameSize.SD:
+                    return 480;
+                case FrameSize.HD720:
+                    return 720;
+                case FrameSize.HD1080:
+                    return 1080;
+                case FrameSize.UHD4K:
+                    return 2160;
+                default:
+                    throw new ArgumentOutOfRangeException(nameof(size));
+            }
+        }
+
+        public static long FrameBytes(this FrameSize size)
+        {
+            return (long)size.Width() * size.Height() * 4;
+        }
+    }
+}
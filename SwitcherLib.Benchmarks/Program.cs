@@ -0,0 +1,20 @@
+using BenchmarkDotNet.Configs;
+using BenchmarkDotNet.Diagnosers;
+using BenchmarkDotNet.Exporters.Json;
+using BenchmarkDotNet.Running;
+
+namespace SwitcherLib.Benchmarks
+{
+    class Program
+    {
+        static void Main(string[] args)
+        {
+            IConfig config = ManualConfig.Create(DefaultConfig.Instance)
+                .AddDiagnoser(MemoryDiagnoser.Default)
+                .AddExporter(JsonExporter.Full)
+                .AddColumn(new ThroughputColumn());
+
+            BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args, config);
+        }
+    }
+}
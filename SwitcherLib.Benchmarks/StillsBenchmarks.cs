@@ -0,0 +1,54 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using BenchmarkDotNet.Attributes;
+
+namespace SwitcherLib.Benchmarks
+{
+    public class StillsBenchmarks
+    {
+        private IntPtr errorBuffer;
+        private IntPtr connection;
+        private NativeBridge.NativeStillInfo[] items;
+        private Switcher switcher;
+
+        [Params(20, 64)]
+        public int StillCount;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            StubBridge.atem_stub_set_still_count(this.StillCount);
+            StubBridge.atem_stub_set_media_player_source(0, 0);
+            StubBridge.atem_stub_set_media_player_source(1, this.StillCount - 1);
+
+            this.errorBuffer = Marshal.AllocHGlobal(StubBridge.ErrorBufferLength);
+            this.connection = StubBridge.Connect(this.errorBuffer);
+            this.items = new NativeBridge.NativeStillInfo[this.StillCount];
+            this.switcher = new Switcher("stub");
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            this.switcher.Dispose();
+            NativeBridge.atem_disconnect(this.connection);
+            Marshal.FreeHGlobal(this.errorBuffer);
+        }
+
+        [Benchmark]
+        public int NativeGetStills()
+        {
+            int count;
+            int result = NativeBridge.atem_get_stills(this.connection, this.items, this.items.Length, out count, this.errorBuffer, StubBridge.ErrorBufferLength);
+            StubBridge.Check(result, this.errorBuffer);
+            return count;
+        }
+
+        [Benchmark]
+        public IList<MediaStill> SwitcherGetStills()
+        {
+            return this.switcher.GetStills();
+        }
+    }
+}
@@ -0,0 +1,36 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace SwitcherLib.Benchmarks
+{
+    // Controls exported by the stub-SDK build of atem_bridge (native/atem_bridge/bench).
+    internal static class StubBridge
+    {
+        private const string LibraryName = "atem_bridge";
+
+        internal const int ErrorBufferLength = 1024;
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void atem_stub_set_still_count(int count);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void atem_stub_set_media_player_source(int mediaPlayer, int stillIndex);
+
+        internal static IntPtr Connect(IntPtr errorBuffer)
+        {
+            IntPtr connection;
+            int failReason;
+            int result = NativeBridge.atem_connect("stub", out connection, out failReason, errorBuffer, ErrorBufferLength);
+            StubBridge.Check(result, errorBuffer);
+            return connection;
+        }
+
+        internal static void Check(int result, IntPtr errorBuffer)
+        {
+            if (result != 0)
+            {
+                throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Native call failed");
+            }
+        }
+    }
+}
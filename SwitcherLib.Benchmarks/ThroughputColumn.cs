@@ -0,0 +1,71 @@
+using System.Globalization;
+using System.Runtime.InteropServices;
+using BenchmarkDotNet.Columns;
+using BenchmarkDotNet.Reports;
+using BenchmarkDotNet.Running;
+
+namespace SwitcherLib.Benchmarks
+{
+    // Reports GB/s from the mean time and the bytes each benchmark touches, taken
+    // from its Size (frame bytes) or StillCount (marshaled NativeStillInfo bytes) parameter.
+    public class ThroughputColumn : IColumn
+    {
+        public string Id => nameof(ThroughputColumn);
+
+        public string ColumnName => "GB/s";
+
+        public bool AlwaysShow => true;
+
+        public ColumnCategory Category => ColumnCategory.Custom;
+
+        public int PriorityInCategory => 0;
+
+        public bool IsNumeric => true;
+
+        public UnitType UnitType => UnitType.Dimensionless;
+
+        public string Legend => "Bytes processed per op divided by the mean time, in GB/s";
+
+        public bool IsAvailable(Summary summary)
+        {
+            return true;
+        }
+
+        public bool IsDefault(Summary summary, BenchmarkCase benchmarkCase)
+        {
+            return false;
+        }
+
+        public string GetValue(Summary summary, BenchmarkCase benchmarkCase)
+        {
+            return this.GetValue(summary, benchmarkCase, SummaryStyle.Default);
+        }
+
+        public string GetValue(Summary summary, BenchmarkCase benchmarkCase, SummaryStyle style)
+        {
+            BenchmarkReport report = summary[benchmarkCase];
+            long bytes = ThroughputColumn.GetBytesPerOperation(benchmarkCase);
+            if (report == null || report.ResultStatistics == null || bytes <= 0)
+            {
+                return "-";
+            }
+
+            return (bytes / report.ResultStatistics.Mean).ToString("0.00", CultureInfo.InvariantCulture);
+        }
+
+        private static long GetBytesPerOperation(BenchmarkCase benchmarkCase)
+        {
+            if (benchmarkCase.Parameters["Size"] is FrameSize size)
+            {
+                return size.FrameBytes();
+            }
+
+            if (benchmarkCase.Parameters["StillCount"] is int stillCount)
+            {
+                return (long)stillCount * Marshal.SizeOf<NativeBridge.NativeStillInfo>();
+            }
+
+            return 0;
+        }
+    }
+}
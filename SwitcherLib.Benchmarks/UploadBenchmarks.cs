@@ -0,0 +1,50 @@
+using System;
+using System.Runtime.InteropServices;
+using BenchmarkDotNet.Attributes;
+
+namespace SwitcherLib.Benchmarks
+{
+    public class UploadBenchmarks
+    {
+        private IntPtr errorBuffer;
+        private IntPtr connection;
+        private byte[] pixels;
+
+        [Params(FrameSize.SD, FrameSize.HD720, FrameSize.HD1080, FrameSize.UHD4K)]
+        public FrameSize Size;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            this.errorBuffer = Marshal.AllocHGlobal(StubBridge.ErrorBufferLength);
+            this.connection = StubBridge.Connect(this.errorBuffer);
+
+            this.pixels = new byte[this.Size.FrameBytes()];
+            new Random(42).NextBytes(this.pixels);
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            NativeBridge.atem_disconnect(this.connection);
+            Marshal.FreeHGlobal(this.errorBuffer);
+        }
+
+        [Benchmark]
+        public void UploadStillBgra()
+        {
+            int result = NativeBridge.atem_upload_still_bgra(
+                this.connection,
+                0,
+                "bench",
+                this.pixels,
+                this.pixels.Length,
+                this.Size.Width(),
+                this.Size.Height(),
+                this.errorBuffer,
+                StubBridge.ErrorBufferLength);
+
+            StubBridge.Check(result, this.errorBuffer);
+        }
+    }
+}
@@ -0,0 +1,13 @@
+using System;
+
+namespace SwitcherLib
+{
+    // Values match atem_alpha_mode in atem_bridge.h.
+    public enum AlphaMode
+    {
+        Straight = 0,
+        Premultiply = 1,
+        Unpremultiply = 2,
+        Opaque = 3,
+    }
+}
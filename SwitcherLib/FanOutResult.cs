@@ -0,0 +1,14 @@
+using System;
+
+namespace SwitcherLib
+{
+    public class FanOutResult
+    {
+        public string Address;
+        public int Width;
+        public int Height;
+        public bool Success;
+        public double LatencyMs;
+        public string Error;
+    }
+}
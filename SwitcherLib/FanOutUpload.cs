@@ -0,0 +1,187 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading.Tasks;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SwitcherLib
+{
+    // Uploads one image to the same slot on many switchers. The image is decoded and
+    // converted once; the uploads then run in parallel from a shared native buffer.
+    // As with Upload, the image must match each switcher's resolution.
+    public class FanOutUpload
+    {
+        private readonly IList<Switcher> switchers;
+        private readonly string filename;
+        private readonly int uploadSlot;
+        private string name;
+
+        public FanOutUpload(IList<Switcher> switchers, string filename, int uploadSlot)
+        {
+            this.switchers = switchers;
+            this.filename = filename;
+            this.uploadSlot = uploadSlot;
+
+            if (!File.Exists(filename))
+            {
+                throw new SwitcherLibException(string.Format("{0} does not exist", filename));
+            }
+
+            if (FrameCache.IsFrameFile(filename))
+            {
+                throw new SwitcherLibException("Frame files cannot be uploaded to several switchers at once, upload the source image instead");
+            }
+
+            // Concurrent uploads through two connections to one switcher would race for
+            // its media pool lock.
+            string duplicate = switchers
+                .GroupBy(switcher => switcher.GetDeviceAddress().Trim(), StringComparer.OrdinalIgnoreCase)
+                .Where(group => group.Count() > 1)
+                .Select(group => group.Key)
+                .FirstOrDefault();
+            if (duplicate != null)
+            {
+                throw new SwitcherLibException(string.Format("{0} is listed more than once", duplicate));
+            }
+        }
+
+        public void SetName(string name)
+        {
+            this.name = name;
+        }
+
+        public string GetName()
+        {
+            if (this.name != null)
+            {
+                return this.name;
+            }
+
+            return Path.GetFileNameWithoutExtension(this.filename);
+        }
+
+        public IList<FanOutResult> Start()
+        {
+            FanOutResult[] results = new FanOutResult[this.switchers.Count];
+
+            Parallel.For(0, this.switchers.Count, index =>
+            {
+                Switcher switcher = this.switchers[index];
+                FanOutResult result = new FanOutResult { Address = switcher.GetDeviceAddress() };
+                results[index] = result;
+
+                try
+                {
+                    switcher.Connect();
+                    result.Width = switcher.GetVideoWidth();
+                    result.Height = switcher.GetVideoHeight();
+                }
+                catch (SwitcherLibException ex)
+                {
+                    result.Error = ex.Message;
+                }
+            });
+
+            List<int> targets = Enumerable.Range(0, results.Length).Where(index => results[index].Error == null).ToList();
+            if (targets.Count == 0)
+            {
+                return results;
+            }
+
+            using SharedFrame frame = this.ConvertFrame(targets, results);
+            targets = targets.Where(index => results[index].Error == null).ToList();
+            if (targets.Count > 0)
+            {
+                this.UploadFrames(targets, results, frame);
+            }
+
+            return results;
+        }
+
+        // Switchers whose resolution differs from the image are marked as failed, as
+        // Upload would reject the image for them.
+        private SharedFrame ConvertFrame(IList<int> targets, FanOutResult[] results)
+        {
+            try
+            {
+                using Image<Rgba32> image = Image.Load<Rgba32>(this.filename);
+
+                foreach (int index in targets)
+                {
+                    FanOutResult result = results[index];
+                    if (result.Width != image.Width || result.Height != image.Height)
+                    {
+                        result.Error = string.Format("Image is {0}x{1} it needs to be the same resolution as the switcher ({2}x{3})", image.Width.ToString(), image.Height.ToString(), result.Width.ToString(), result.Height.ToString());
+                    }
+                }
+
+                return new SharedFrame(Upload.ConvertPixels(image), image.Width, image.Height);
+            }
+            catch (Exception ex) when (ex is not SwitcherLibException)
+            {
+                throw new SwitcherLibException(ex.Message, ex);
+            }
+        }
+
+        private void UploadFrames(IList<int> targets, FanOutResult[] results, SharedFrame frame)
+        {
+            IntPtr[] connections = new IntPtr[targets.Count];
+            IntPtr[] buffers = new IntPtr[targets.Count];
+            for (int i = 0; i < targets.Count; i++)
+            {
+                connections[i] = this.switchers[targets[i]].GetNativeConnection();
+                buffers[i] = frame.GetNativeBuffer();
+            }
+
+            NativeBridge.NativeFanoutResult[] nativeResults = new NativeBridge.NativeFanoutResult[targets.Count];
+
+            const int bufferLength = 1024;
+            IntPtr errorBuffer = Marshal.AllocHGlobal(bufferLength);
+            int status;
+            string message;
+
+            try
+            {
+                for (int i = 0; i < bufferLength; i++)
+                {
+                    Marshal.WriteByte(errorBuffer, i, 0);
+                }
+
+                status = NativeBridge.atem_upload_still_fanout(
+                    connections,
+                    buffers,
+                    targets.Count,
+                    this.uploadSlot,
+                    this.GetName(),
+                    nativeResults,
+                    errorBuffer,
+                    bufferLength);
+                message = Marshal.PtrToStringAnsi(errorBuffer) ?? "Fan-out upload failed";
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(errorBuffer);
+            }
+
+            // A non-zero status normally means some uploads failed and their results say
+            // why; if none did, the call was rejected before any upload started.
+            bool rejected = status != 0 && nativeResults.All(item => item.Status == 0);
+            for (int i = 0; i < targets.Count; i++)
+            {
+                FanOutResult result = results[targets[i]];
+                if (rejected)
+                {
+                    result.Error = message;
+                    continue;
+                }
+
+                result.Success = nativeResults[i].Status == 0;
+                result.LatencyMs = nativeResults[i].LatencyMs;
+                result.Error = result.Success ? null : nativeResults[i].Error;
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace SwitcherLib
+{
+    public class FrameCache
+    {
+        public const string Extension = ".atemframe";
+
+        // Recorded in frames rendered for an explicit size rather than for a switcher.
+        public const int UnknownVideoMode = -1;
+
+        // ATEM_FRAME_FILE_MAGIC in atem_bridge.h.
+        private const string Magic = "ATEMFRM1";
+
+        public static bool IsFrameFile(string filename)
+        {
+            return string.Equals(Path.GetExtension(filename), FrameCache.Extension, StringComparison.OrdinalIgnoreCase);
+        }
+
+        // Returns the MD5 of the frame file's payload, as recorded in its header, in the
+        // same form as MediaStill.Hash. Offsets follow atem_frame_file_header.
+        internal static string ReadHash(string filename)
+        {
+            const int headerLength = 64;
+            const int hashOffset = 48;
+            const int hashLength = 16;
+
+            byte[] header = new byte[headerLength];
+            try
+            {
+                using FileStream stream = File.OpenRead(filename);
+                stream.ReadExactly(header, 0, headerLength);
+            }
+            catch (EndOfStreamException)
+            {
+                throw new SwitcherLibException(string.Format("{0} is not a valid frame file", filename));
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException)
+            {
+                throw new SwitcherLibException(ex.Message, ex);
+            }
+
+            if (Encoding.ASCII.GetString(header, 0, FrameCache.Magic.Length) != FrameCache.Magic)
+            {
+                throw new SwitcherLibException(string.Format("{0} is not a valid frame file", filename));
+            }
+
+            return Convert.ToHexString(header, hashOffset, hashLength);
+        }
+
+        public static string GetFramePath(string filename, string outputDirectory)
+        {
+            return Path.Combine(outputDirectory, Path.GetFileNameWithoutExtension(filename) + FrameCache.Extension);
+        }
+
+        public static void Render(string filename, string outputPath, int width, int height, int videoMode)
+        {
+            if (!File.Exists(filename))
+            {
+                throw new SwitcherLibException(string.Format("{0} does not exist", filename));
+            }
+
+            byte[] imageData = Upload.ConvertImage(filename, width, height);
+
+            const int bufferLength = 1024;
+            IntPtr errorBuffer = Marshal.AllocHGlobal(bufferLength);
+
+            try
+            {
+                for (int i = 0; i < bufferLength; i++)
+                {
+                    Marshal.WriteByte(errorBuffer, i, 0);
+                }
+
+                int result = NativeBridge.atem_write_frame_file(
+                    Path.GetFullPath(outputPath),
+                    imageData,
+                    imageData.Length,
+                    width,
+                    height,
+                    videoMode,
+                    errorBuffer,
+                    bufferLength);
+
+                if (result != 0)
+                {
+                    throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Unable to write frame file");
+                }
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(errorBuffer);
+            }
+        }
+
+        public static IList<string> RenderAll(IList<string> filenames, string outputDirectory, int width, int height, int videoMode)
+        {
+            string[] outputs = new string[filenames.Count];
+            for (int index = 0; index < filenames.Count; index++)
+            {
+                outputs[index] = FrameCache.GetFramePath(filenames[index], outputDirectory);
+            }
+
+            // Inputs that differ only by directory or extension map to the same frame
+            // file; rendering them in parallel would race on it.
+            List<string> collisions = outputs
+                .Select((output, index) => (output: Path.GetFullPath(output), filename: filenames[index]))
+                .GroupBy(item => item.output, StringComparer.OrdinalIgnoreCase)
+                .Where(group => group.Count() > 1)
+                .Select(group => string.Format("{0} would be rendered from {1}", group.Key, string.Join(", ", group.Select(item => item.filename))))
+                .ToList();
+            if (collisions.Count > 0)
+            {
+                throw new SwitcherLibException(string.Join(Environment.NewLine, collisions));
+            }
+
+            Directory.CreateDirectory(outputDirectory);
+
+            ConcurrentQueue<string> errors = new ConcurrentQueue<string>();
+
+            Parallel.For(0, filenames.Count, index =>
+            {
+                try
+                {
+                    FrameCache.Render(filenames[index], outputs[index], width, height, videoMode);
+                }
+                catch (SwitcherLibException ex)
+                {
+                    errors.Enqueue(string.Format("{0}: {1}", filenames[index], ex.Message));
+                }
+            });
+
+            if (!errors.IsEmpty)
+            {
+                throw new SwitcherLibException(string.Join(Environment.NewLine, errors));
+            }
+
+            return outputs;
+        }
+    }
+}
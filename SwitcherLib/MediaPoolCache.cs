@@ -0,0 +1,343 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+
+namespace SwitcherLib
+{
+    // Treats the switcher's media pool as a fixed-size cache keyed by the content of
+    // each asset: the MD5 of the frame the switcher would receive. After an upload the
+    // cache records the hash the switcher reports for the slot and trusts the slot for
+    // as long as that hash is unchanged. Loading an asset that is not tracked is
+    // uploaded to a free slot, or to the slot that was least recently cued. Slots
+    // assigned to a media player are never evicted.
+    //
+    // Stills loaded by an earlier run or another tool are only found by assuming the
+    // switcher reports the MD5 of the uploaded frame as a still's hash. Where it does
+    // not, those stills are never matched and the asset is uploaded again.
+    //
+    // Slots are numbered from 1, as in MediaStill.
+    public class MediaPoolCache
+    {
+        private class Entry
+        {
+            public string Digest;
+            public int Slot;
+            public string SwitcherHash;
+        }
+
+        private class FileDigest
+        {
+            public long Length;
+            public DateTime LastWriteTimeUtc;
+            public int Width;
+            public int Height;
+            public string Digest;
+        }
+
+        private readonly Switcher switcher;
+        private readonly int firstSlot;
+        private readonly int lastSlot;
+        private readonly Dictionary<string, Entry> entries = new Dictionary<string, Entry>();
+        private readonly Dictionary<int, Entry> entriesBySlot = new Dictionary<int, Entry>();
+        private readonly Dictionary<int, long> lastCued = new Dictionary<int, long>();
+        private readonly Dictionary<string, FileDigest> digests = new Dictionary<string, FileDigest>();
+        private readonly object sync = new object();
+        private long clock;
+        private long hits;
+        private long misses;
+        private long evictions;
+
+        public MediaPoolCache(Switcher switcher)
+            : this(switcher, 1, int.MaxValue)
+        {
+        }
+
+        // Limits the cache to slots firstSlot..lastSlot, leaving the rest for manual use.
+        public MediaPoolCache(Switcher switcher, int firstSlot, int lastSlot)
+        {
+            if (firstSlot < 1 || lastSlot < firstSlot)
+            {
+                throw new SwitcherLibException(string.Format("Invalid slot range: {0}-{1}", firstSlot, lastSlot));
+            }
+
+            this.switcher = switcher;
+            this.firstSlot = firstSlot;
+            this.lastSlot = lastSlot;
+        }
+
+        public int EnsureLoaded(string filename)
+        {
+            return this.EnsureLoaded(filename, null);
+        }
+
+        // Returns the slot holding the asset, uploading it first if it is not in the pool.
+        public int EnsureLoaded(string filename, string name)
+        {
+            if (!File.Exists(filename))
+            {
+                throw new SwitcherLibException(string.Format("{0} does not exist", filename));
+            }
+
+            string digest = this.GetDigest(filename, out byte[] imageData);
+
+            lock (this.sync)
+            {
+                Dictionary<int, MediaStill> stills = this.RefreshStills();
+
+                int slot = this.FindSlot(digest, stills);
+                if (slot != 0)
+                {
+                    this.hits++;
+                    this.lastCued[slot] = ++this.clock;
+                    Log.Debug(string.Format("Cache hit for {0} in slot {1}", filename, slot.ToString()));
+                    return slot;
+                }
+
+                this.misses++;
+
+                if (stills.Count == 0)
+                {
+                    throw new SwitcherLibException(string.Format(
+                        "No media pool slots in range {0}-{1}, the pool has {2}",
+                        this.firstSlot.ToString(),
+                        this.lastSlot.ToString(),
+                        this.switcher.GetStills().Count.ToString()));
+                }
+
+                MediaStill target = this.SelectSlot(stills.Values);
+                if (target.Valid)
+                {
+                    Log.Debug(string.Format("Evicting \"{0}\" from slot {1}", target.Name, target.Slot.ToString()));
+                }
+
+                Upload upload = new Upload(this.switcher, filename, target.Slot - 1);
+                if (name != null)
+                {
+                    upload.SetName(name);
+                }
+                if (imageData != null)
+                {
+                    upload.SetImageData(imageData);
+                }
+                upload.Start();
+
+                // Only forget what the slot held once it has actually been replaced.
+                if (target.Valid)
+                {
+                    this.evictions++;
+                }
+                if (this.entriesBySlot.TryGetValue(target.Slot, out Entry evicted))
+                {
+                    this.Remove(evicted);
+                }
+
+                MediaStill loaded = this.switcher.GetStills().First(item => item.Slot == target.Slot);
+                this.Track(digest, target.Slot, loaded.Hash);
+                this.lastCued[target.Slot] = ++this.clock;
+
+                return target.Slot;
+            }
+        }
+
+        // Returns the slot holding the asset without uploading it, or 0 if it is not in the pool.
+        public int GetSlot(string filename)
+        {
+            string digest = this.GetDigest(filename, out _);
+
+            lock (this.sync)
+            {
+                return this.FindSlot(digest, this.RefreshStills());
+            }
+        }
+
+        public long GetHits()
+        {
+            lock (this.sync)
+            {
+                return this.hits;
+            }
+        }
+
+        public long GetMisses()
+        {
+            lock (this.sync)
+            {
+                return this.misses;
+            }
+        }
+
+        public long GetEvictions()
+        {
+            lock (this.sync)
+            {
+                return this.evictions;
+            }
+        }
+
+        public void ResetCounters()
+        {
+            lock (this.sync)
+            {
+                this.hits = 0;
+                this.misses = 0;
+                this.evictions = 0;
+            }
+        }
+
+        // Frame files carry the digest in their header. Images are converted for the
+        // switcher's resolution and hashed; the converted pixels are handed back so a
+        // miss does not decode the image twice. Digests are remembered by path, size,
+        // modification time and resolution, so repeat loads do not touch the pixels.
+        private string GetDigest(string filename, out byte[] imageData)
+        {
+            imageData = null;
+
+            FileInfo info = new FileInfo(filename);
+            if (!info.Exists)
+            {
+                throw new SwitcherLibException(string.Format("{0} does not exist", filename));
+            }
+
+            bool frameFile = FrameCache.IsFrameFile(filename);
+            int width = frameFile ? 0 : this.switcher.GetVideoWidth();
+            int height = frameFile ? 0 : this.switcher.GetVideoHeight();
+
+            lock (this.digests)
+            {
+                if (this.digests.TryGetValue(info.FullName, out FileDigest known)
+                    && known.Length == info.Length
+                    && known.LastWriteTimeUtc == info.LastWriteTimeUtc
+                    && known.Width == width
+                    && known.Height == height)
+                {
+                    return known.Digest;
+                }
+            }
+
+            string digest;
+            if (frameFile)
+            {
+                digest = FrameCache.ReadHash(filename);
+            }
+            else
+            {
+                imageData = Upload.ConvertImage(filename, width, height);
+                digest = Convert.ToHexString(MD5.HashData(imageData));
+            }
+
+            lock (this.digests)
+            {
+                this.digests[info.FullName] = new FileDigest
+                {
+                    Length = info.Length,
+                    LastWriteTimeUtc = info.LastWriteTimeUtc,
+                    Width = width,
+                    Height = height,
+                    Digest = digest,
+                };
+            }
+
+            return digest;
+        }
+
+        // Reads the managed slots. A still on a media player is in use, so it counts as
+        // cued on every refresh and is not the first to go once it is taken off air.
+        private Dictionary<int, MediaStill> RefreshStills()
+        {
+            Dictionary<int, MediaStill> stills = this.switcher.GetStills()
+                .Where(item => item.Slot >= this.firstSlot && item.Slot <= this.lastSlot)
+                .ToDictionary(item => item.Slot);
+
+            foreach (MediaStill still in stills.Values.Where(item => item.MediaPlayer != 0).OrderBy(item => item.Slot))
+            {
+                this.lastCued[still.Slot] = ++this.clock;
+            }
+
+            return stills;
+        }
+
+        private int FindSlot(string digest, Dictionary<int, MediaStill> stills)
+        {
+            if (this.entries.TryGetValue(digest, out Entry entry))
+            {
+                // The slot may have been overwritten behind our back; only trust it
+                // while the switcher still reports the hash we saw after uploading.
+                if (stills.TryGetValue(entry.Slot, out MediaStill still) && still.Valid && still.Hash == entry.SwitcherHash)
+                {
+                    return entry.Slot;
+                }
+
+                this.Remove(entry);
+            }
+
+            // The asset may already be in the pool from an earlier run or another tool.
+            MediaStill match = stills.Values
+                .Where(item => item.Valid && string.Equals(item.Hash, digest, StringComparison.OrdinalIgnoreCase))
+                .OrderBy(item => item.Slot)
+                .FirstOrDefault();
+            if (match == null)
+            {
+                return 0;
+            }
+
+            if (this.entriesBySlot.TryGetValue(match.Slot, out Entry replaced))
+            {
+                this.Remove(replaced);
+            }
+
+            this.Track(digest, match.Slot, match.Hash);
+            return match.Slot;
+        }
+
+        // Prefers an empty slot. Otherwise picks the least recently cued slot that no
+        // media player is showing; slots filled outside this cache count as never cued.
+        private MediaStill SelectSlot(IEnumerable<MediaStill> stills)
+        {
+            MediaStill selected = null;
+            long selectedCued = long.MaxValue;
+
+            foreach (MediaStill still in stills.OrderBy(item => item.Slot))
+            {
+                if (!still.Valid)
+                {
+                    return still;
+                }
+
+                if (still.MediaPlayer != 0)
+                {
+                    continue;
+                }
+
+                long cued = this.lastCued.TryGetValue(still.Slot, out long value) ? value : 0;
+                if (cued < selectedCued)
+                {
+                    selected = still;
+                    selectedCued = cued;
+                }
+            }
+
+            if (selected == null)
+            {
+                throw new SwitcherLibException("No media pool slot can be evicted, every slot is assigned to a media player");
+            }
+
+            return selected;
+        }
+
+        private void Track(string digest, int slot, string switcherHash)
+        {
+            Entry entry = new Entry { Digest = digest, Slot = slot, SwitcherHash = switcherHash };
+            this.entries[digest] = entry;
+            this.entriesBySlot[slot] = entry;
+        }
+
+        private void Remove(Entry entry)
+        {
+            this.entries.Remove(entry.Digest);
+            this.entriesBySlot.Remove(entry.Slot);
+            this.lastCued.Remove(entry.Slot);
+        }
+    }
+}
@@ -9,6 +9,9 @@ namespace SwitcherLib
         public int Slot;
         public int MediaPlayer;
 
+        // Not serialised, so the media pool listing formats are unchanged.
+        internal bool Valid;
+
         public string ToCSV()
         {
             return string.Join(",", this.Slot.ToString(), "\"" + this.Name + "\"", "\"" + this.Hash + "\"", this.MediaPlayer.ToString());
@@ -18,6 +18,18 @@ namespace SwitcherLib
 
             [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 33)]
             public string Hash;
+
+            public int Valid;
+        }
+
+        [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+        internal struct NativeFanoutResult
+        {
+            public double LatencyMs;
+            public int Status;
+
+            [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 256)]
+            public string Error;
         }
 
         [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
@@ -39,6 +51,13 @@ namespace SwitcherLib
             IntPtr errorBuffer,
             int errorBufferLength);
 
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int atem_get_video_mode(
+            IntPtr connection,
+            out int outVideoMode,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
         [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int atem_get_video_dimensions(
             IntPtr connection,
@@ -68,6 +87,77 @@ namespace SwitcherLib
             IntPtr errorBuffer,
             int errorBufferLength);
 
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int atem_upload_still_bgra_alpha(
+            IntPtr connection,
+            int slotZeroBased,
+            string name,
+            byte[] bgraPixels,
+            int pixelCount,
+            int width,
+            int height,
+            int alphaMode,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int atem_upload_still_fill_key(
+            IntPtr connection,
+            int fillSlotZeroBased,
+            int keySlotZeroBased,
+            string name,
+            byte[] bgraPixels,
+            int pixelCount,
+            int width,
+            int height,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int atem_write_frame_file(
+            string path,
+            byte[] bgraPixels,
+            int pixelCount,
+            int width,
+            int height,
+            int videoMode,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int atem_upload_still_mapped(
+            IntPtr connection,
+            int slotZeroBased,
+            string name,
+            string path,
+            out int outSkipped,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int atem_frame_buffer_create(
+            byte[] bgraPixels,
+            int pixelCount,
+            int width,
+            int height,
+            out IntPtr outBuffer,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void atem_frame_buffer_release(IntPtr buffer);
+
+        [DllImport(LibraryName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int atem_upload_still_fanout(
+            IntPtr[] connections,
+            IntPtr[] buffers,
+            int count,
+            int slotZeroBased,
+            string name,
+            [Out] NativeFanoutResult[] outResults,
+            IntPtr errorBuffer,
+            int errorBufferLength);
+
         internal static string ReadAnsiBuffer(IntPtr ptr)
         {
             return Marshal.PtrToStringAnsi(ptr) ?? string.Empty;
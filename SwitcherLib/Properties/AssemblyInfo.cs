@@ -19,6 +19,8 @@ using System.Runtime.InteropServices;
 // COM, set the ComVisible attribute to true on that type.
 [assembly: ComVisible(false)]
 
+[assembly: InternalsVisibleTo("SwitcherLib.Benchmarks")]
+
 // The following GUID is for the ID of the typelib if this project is exposed to COM
 [assembly: Guid("b8ea4e08-548d-49a9-8fa0-50996b2d0362")]
 
@@ -0,0 +1,65 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace SwitcherLib
+{
+    // A converted frame held once in native memory and shared read-only by every
+    // upload that uses it. The native buffer is reference counted; disposing this
+    // releases the managed side's reference.
+    public class SharedFrame : IDisposable
+    {
+        private IntPtr nativeBuffer;
+
+        public SharedFrame(byte[] imageData, int width, int height)
+        {
+            this.Width = width;
+            this.Height = height;
+
+            const int bufferLength = 1024;
+            IntPtr errorBuffer = Marshal.AllocHGlobal(bufferLength);
+
+            try
+            {
+                for (int i = 0; i < bufferLength; i++)
+                {
+                    Marshal.WriteByte(errorBuffer, i, 0);
+                }
+
+                int result = NativeBridge.atem_frame_buffer_create(imageData, imageData.Length, width, height, out this.nativeBuffer, errorBuffer, bufferLength);
+                if (result != 0)
+                {
+                    throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Unable to create frame buffer");
+                }
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(errorBuffer);
+            }
+        }
+
+        public int Width { get; }
+
+        public int Height { get; }
+
+        internal IntPtr GetNativeBuffer()
+        {
+            return this.nativeBuffer;
+        }
+
+        public void Dispose()
+        {
+            if (this.nativeBuffer != IntPtr.Zero)
+            {
+                NativeBridge.atem_frame_buffer_release(this.nativeBuffer);
+                this.nativeBuffer = IntPtr.Zero;
+            }
+
+            GC.SuppressFinalize(this);
+        }
+
+        ~SharedFrame()
+        {
+            this.Dispose();
+        }
+    }
+}
@@ -50,6 +50,11 @@ namespace SwitcherLib
             }
         }
 
+        public string GetDeviceAddress()
+        {
+            return this.deviceAddress;
+        }
+
         public string GetProductName()
         {
             this.Connect();
@@ -93,6 +98,34 @@ namespace SwitcherLib
             return this.GetVideoDimensions().width;
         }
 
+        public int GetVideoMode()
+        {
+            this.Connect();
+            const int bufferLength = 512;
+            IntPtr errorBuffer = Marshal.AllocHGlobal(bufferLength);
+
+            try
+            {
+                for (int i = 0; i < bufferLength; i++)
+                {
+                    Marshal.WriteByte(errorBuffer, i, 0);
+                }
+
+                int videoMode;
+                int result = NativeBridge.atem_get_video_mode(this.nativeConnection, out videoMode, errorBuffer, bufferLength);
+                if (result != 0)
+                {
+                    throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Unable to get video mode");
+                }
+
+                return videoMode;
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(errorBuffer);
+            }
+        }
+
         public IList<MediaStill> GetStills()
         {
             this.Connect();
@@ -130,6 +163,7 @@ namespace SwitcherLib
                         MediaPlayer = nativeItems[index].MediaPlayer,
                         Name = nativeItems[index].Name,
                         Hash = nativeItems[index].Hash,
+                        Valid = nativeItems[index].Valid != 0,
                     });
                 }
 
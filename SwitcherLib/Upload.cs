@@ -21,6 +21,10 @@ namespace SwitcherLib
         private string name;
         private readonly Switcher switcher;
         private int progress;
+        private bool skipped;
+        private AlphaMode alphaMode = AlphaMode.Straight;
+        private int keySlot = -1;
+        private byte[] imageData;
 
         public Upload(Switcher switcher, string filename, int uploadSlot)
         {
@@ -46,11 +50,40 @@ namespace SwitcherLib
             this.name = name;
         }
 
+        public void SetAlphaMode(AlphaMode alphaMode)
+        {
+            this.alphaMode = alphaMode;
+        }
+
+        // Uploads a premultiplied fill to the upload slot and the alpha channel as a
+        // luma key still to this slot, instead of a single still.
+        public void SetKeySlot(int keySlot)
+        {
+            if (keySlot < 0)
+            {
+                throw new SwitcherLibException(string.Format("Invalid key slot: {0}", keySlot.ToString()));
+            }
+
+            this.keySlot = keySlot;
+        }
+
+        // Uploads pixels the caller has already converted from the file, instead of
+        // decoding it again.
+        internal void SetImageData(byte[] imageData)
+        {
+            this.imageData = imageData;
+        }
+
         public int GetProgress()
         {
             return this.progress;
         }
 
+        public bool WasSkipped()
+        {
+            return this.skipped;
+        }
+
         public void Start()
         {
             if (this.currentStatus != Status.NotStarted)
@@ -58,10 +91,29 @@ namespace SwitcherLib
                 return;
             }
 
+            if (FrameCache.IsFrameFile(this.filename) && (this.alphaMode != AlphaMode.Straight || this.keySlot >= 0))
+            {
+                throw new SwitcherLibException("Alpha processing is not available for frame files, apply it before rendering");
+            }
+
+            // The fill/key split premultiplies straight alpha itself; any other mode
+            // would be applied twice or dropped.
+            if (this.keySlot >= 0 && this.alphaMode != AlphaMode.Straight)
+            {
+                throw new SwitcherLibException("Alpha modes cannot be combined with a key slot, the fill/key split expects straight alpha");
+            }
+
             this.currentStatus = Status.Started;
             this.progress = 0;
-            byte[] imageData = this.ConvertImage();
-            this.UploadImage(imageData);
+            if (FrameCache.IsFrameFile(this.filename))
+            {
+                this.UploadFrameFile();
+            }
+            else
+            {
+                byte[] imageData = this.imageData ?? this.ConvertImage();
+                this.UploadImage(imageData);
+            }
             this.progress = 100;
             this.currentStatus = Status.Completed;
         }
@@ -81,14 +133,66 @@ namespace SwitcherLib
                     Marshal.WriteByte(errorBuffer, i, 0);
                 }
 
-                int result = NativeBridge.atem_upload_still_bgra(
+                int result;
+                if (this.keySlot >= 0)
+                {
+                    result = NativeBridge.atem_upload_still_fill_key(
+                        this.switcher.GetNativeConnection(),
+                        this.uploadSlot,
+                        this.keySlot,
+                        this.GetName(),
+                        imageData,
+                        imageData.Length,
+                        width,
+                        height,
+                        errorBuffer,
+                        bufferLength);
+                }
+                else
+                {
+                    result = NativeBridge.atem_upload_still_bgra_alpha(
+                        this.switcher.GetNativeConnection(),
+                        this.uploadSlot,
+                        this.GetName(),
+                        imageData,
+                        imageData.Length,
+                        width,
+                        height,
+                        (int)this.alphaMode,
+                        errorBuffer,
+                        bufferLength);
+                }
+
+                if (result != 0)
+                {
+                    throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Upload failed");
+                }
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(errorBuffer);
+            }
+        }
+
+        private void UploadFrameFile()
+        {
+            const int bufferLength = 1024;
+            IntPtr errorBuffer = Marshal.AllocHGlobal(bufferLength);
+
+            try
+            {
+                for (int i = 0; i < bufferLength; i++)
+                {
+                    Marshal.WriteByte(errorBuffer, i, 0);
+                }
+
+                int skippedFlag;
+                int result = NativeBridge.atem_upload_still_mapped(
                     this.switcher.GetNativeConnection(),
                     this.uploadSlot,
                     this.GetName(),
-                    imageData,
-                    imageData.Length,
-                    width,
-                    height,
+                    Path.GetFullPath(this.filename),
+                    out skippedFlag,
                     errorBuffer,
                     bufferLength);
 
@@ -96,6 +200,8 @@ namespace SwitcherLib
                 {
                     throw new SwitcherLibException(Marshal.PtrToStringAnsi(errorBuffer) ?? "Upload failed");
                 }
+
+                this.skipped = skippedFlag != 0;
             }
             finally
             {
@@ -104,31 +210,22 @@ namespace SwitcherLib
         }
 
         protected byte[] ConvertImage()
+        {
+            return Upload.ConvertImage(this.filename, this.switcher.GetVideoWidth(), this.switcher.GetVideoHeight());
+        }
+
+        internal static byte[] ConvertImage(string filename, int width, int height)
         {
             try
             {
-                using Image<Rgba32> image = Image.Load<Rgba32>(this.filename);
+                using Image<Rgba32> image = Image.Load<Rgba32>(filename);
 
-                if (image.Width != this.switcher.GetVideoWidth() || image.Height != this.switcher.GetVideoHeight())
+                if (image.Width != width || image.Height != height)
                 {
                     throw new SwitcherLibException(string.Format("Image is {0}x{1} it needs to be the same resolution as the switcher", image.Width.ToString(), image.Height.ToString()));
                 }
 
-                byte[] output = new byte[image.Width * image.Height * 4];
-                for (int y = 0; y < image.Height; y++)
-                {
-                    for (int x = 0; x < image.Width; x++)
-                    {
-                        Rgba32 pixel = image[x, y];
-                        int index = (y * image.Width + x) * 4;
-                        output[index] = pixel.B;
-                        output[index + 1] = pixel.G;
-                        output[index + 2] = pixel.R;
-                        output[index + 3] = pixel.A;
-                    }
-                }
-
-                return output;
+                return Upload.ConvertPixels(image);
             }
             catch (Exception ex)
             {
@@ -136,6 +233,25 @@ namespace SwitcherLib
             }
         }
 
+        internal static byte[] ConvertPixels(Image<Rgba32> image)
+        {
+            byte[] output = new byte[image.Width * image.Height * 4];
+            for (int y = 0; y < image.Height; y++)
+            {
+                for (int x = 0; x < image.Width; x++)
+                {
+                    Rgba32 pixel = image[x, y];
+                    int index = (y * image.Width + x) * 4;
+                    output[index] = pixel.B;
+                    output[index + 1] = pixel.G;
+                    output[index + 2] = pixel.R;
+                    output[index + 3] = pixel.A;
+                }
+            }
+
+            return output;
+        }
+
         public string GetName()
         {
             if (this.name != null)
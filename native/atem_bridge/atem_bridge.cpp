@@ -2,32 +2,73 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <system_error>
 #include <thread>
+#include <vector>
 
 #include <CoreFoundation/CoreFoundation.h>
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define ATEM_BRIDGE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define ATEM_BRIDGE_NEON 1
+#endif
 
 #include "BMDSwitcherAPI.h"
+#include "md5.h"
+
+// The hash the switcher reported for a slot after a frame file was uploaded to it,
+// keyed by the frame file's payload hash.
+struct atem_mapped_upload
+{
+    uint8_t payload_hash[16];
+    BMDSwitcherHash switcher_hash;
+};
 
 struct atem_connection
 {
     IBMDSwitcher* switcher = nullptr;
     IBMDSwitcherMediaPool* media_pool = nullptr;
     IBMDSwitcherStills* stills = nullptr;
+    std::mutex mapped_mutex;
+    std::map<int32_t, atem_mapped_upload> mapped_uploads;
+};
+
+struct atem_frame_buffer
+{
+    std::atomic<int32_t> ref_count{1};
+    int32_t width = 0;
+    int32_t height = 0;
+    size_t size = 0;
+    std::unique_ptr<uint8_t[]> pixels;
 };
 
 namespace
 {
+    using atem_bridge_detail::Md5;
+
     constexpr int32_t kErrorBufferMin = 1;
     constexpr int32_t kSuccess = 0;
     constexpr int32_t kInternalError = -1;
     constexpr int32_t kTimeoutError = -2;
+    constexpr int32_t kBytesPerPixel = 4;
 
     constexpr char kBMDSwitcherBundlePath[] = "/Library/Application Support/Blackmagic Design/Switchers/BMDSwitcherAPI.bundle";
 
@@ -244,6 +285,441 @@ namespace
 
         return kSuccess;
     }
+
+    // Alpha kernels. Each reads straight BGRA pixels once and writes the switcher
+    // frame directly, so alpha handling happens in the copy into the frame rather
+    // than as a separate pass. Pixels are B, G, R, A bytes (8-bit ARGB, little endian).
+
+    // Rounded c * a / 255, exact for all 8-bit inputs.
+    inline uint8_t MultiplyAlpha(uint32_t value, uint32_t alpha)
+    {
+        uint32_t t = value * alpha + 128;
+        return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+#if defined(ATEM_BRIDGE_SSE2)
+    // Premultiplies four pixels using the same rounding as MultiplyAlpha.
+    inline __m128i PremultiplyBlock(__m128i packed)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rounding = _mm_set1_epi16(128);
+        const __m128i colour_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        const __m128i alpha_multiplier = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+        __m128i halves[2] = { _mm_unpacklo_epi8(packed, zero), _mm_unpackhi_epi8(packed, zero) };
+        for (__m128i& half : halves)
+        {
+            // Broadcast each pixel's alpha across its lanes; alpha itself is scaled by 255.
+            __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, 0xFF), 0xFF);
+            __m128i multiplier = _mm_or_si128(_mm_and_si128(alpha, colour_mask), alpha_multiplier);
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(half, multiplier), rounding);
+            half = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        return _mm_packus_epi16(halves[0], halves[1]);
+    }
+#elif defined(ATEM_BRIDGE_NEON)
+    // Premultiplies the B, G and R planes of sixteen pixels using the same rounding as MultiplyAlpha.
+    inline void PremultiplyPlanes(uint8x16x4_t& planes)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            uint16x8_t low = vmull_u8(vget_low_u8(planes.val[c]), vget_low_u8(planes.val[3]));
+            uint16x8_t high = vmull_u8(vget_high_u8(planes.val[c]), vget_high_u8(planes.val[3]));
+            planes.val[c] = vcombine_u8(
+                vraddhn_u16(low, vrshrq_n_u16(low, 8)),
+                vraddhn_u16(high, vrshrq_n_u16(high, 8)));
+        }
+    }
+#endif
+
+    void PremultiplyPixels(const uint8_t* source, uint8_t* destination, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(ATEM_BRIDGE_SSE2)
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), PremultiplyBlock(packed));
+        }
+#elif defined(ATEM_BRIDGE_NEON)
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x4_t planes = vld4q_u8(source + i * 4);
+            PremultiplyPlanes(planes);
+            vst4q_u8(destination + i * 4, planes);
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            const uint8_t* in = source + i * 4;
+            uint8_t* out = destination + i * 4;
+            uint32_t alpha = in[3];
+            out[0] = MultiplyAlpha(in[0], alpha);
+            out[1] = MultiplyAlpha(in[1], alpha);
+            out[2] = MultiplyAlpha(in[2], alpha);
+            out[3] = static_cast<uint8_t>(alpha);
+        }
+    }
+
+    // 8.24 reciprocals of alpha / 255, rounded up so halfway cases round like
+    // c * 255 / a does. Integer division does not vectorise on SSE2 or NEON, so
+    // un-premultiplying multiplies by a looked-up reciprocal instead.
+    struct UnpremultiplyTable
+    {
+        UnpremultiplyTable()
+        {
+            scale[0] = 0;
+            for (uint32_t alpha = 1; alpha < 256; ++alpha)
+            {
+                scale[alpha] = static_cast<uint32_t>(((255ull << 24) + alpha - 1) / alpha);
+            }
+        }
+
+        uint32_t scale[256];
+    };
+
+#if defined(ATEM_BRIDGE_SSE2)
+    // Rounded (channel * scale) >> 24 for four 32-bit lanes, clamped to 255. The
+    // products need more than 32 bits, so even and odd lanes are multiplied apart.
+    inline __m128i UnpremultiplyLanes(__m128i channel, __m128i scale)
+    {
+        const __m128i rounding = _mm_set1_epi64x(1 << 23);
+        const __m128i limit = _mm_set1_epi32(255);
+
+        __m128i even = _mm_srli_epi64(_mm_add_epi64(_mm_mul_epu32(channel, scale), rounding), 24);
+        __m128i odd = _mm_srli_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(channel, 32), _mm_srli_epi64(scale, 32)), rounding), 24);
+        __m128i lanes = _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+
+        __m128i over = _mm_cmpgt_epi32(lanes, limit);
+        return _mm_or_si128(_mm_andnot_si128(over, lanes), _mm_and_si128(over, limit));
+    }
+#endif
+
+    void UnpremultiplyPixels(const uint8_t* source, uint8_t* destination, size_t pixels)
+    {
+        static const UnpremultiplyTable table;
+
+        size_t i = 0;
+#if defined(ATEM_BRIDGE_SSE2)
+        const __m128i byte_mask = _mm_set1_epi32(0xFF);
+        const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 4 <= pixels; i += 4)
+        {
+            const uint8_t* in = source + i * 4;
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            __m128i scale = _mm_set_epi32(
+                static_cast<int>(table.scale[in[15]]),
+                static_cast<int>(table.scale[in[11]]),
+                static_cast<int>(table.scale[in[7]]),
+                static_cast<int>(table.scale[in[3]]));
+
+            __m128i blue = UnpremultiplyLanes(_mm_and_si128(packed, byte_mask), scale);
+            __m128i green = UnpremultiplyLanes(_mm_and_si128(_mm_srli_epi32(packed, 8), byte_mask), scale);
+            __m128i red = UnpremultiplyLanes(_mm_and_si128(_mm_srli_epi32(packed, 16), byte_mask), scale);
+
+            __m128i result = _mm_or_si128(
+                _mm_or_si128(blue, _mm_slli_epi32(green, 8)),
+                _mm_or_si128(_mm_slli_epi32(red, 16), _mm_and_si128(packed, alpha_mask)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), result);
+        }
+#elif defined(ATEM_BRIDGE_NEON)
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x4_t planes = vld4q_u8(source + i * 4);
+
+            uint32_t scales[16];
+            for (int j = 0; j < 16; ++j)
+            {
+                scales[j] = table.scale[source[(i + j) * 4 + 3]];
+            }
+
+            for (int c = 0; c < 3; ++c)
+            {
+                uint16x8_t halves[2] = { vmovl_u8(vget_low_u8(planes.val[c])), vmovl_u8(vget_high_u8(planes.val[c])) };
+                uint16x4_t narrowed[4];
+                for (int q = 0; q < 4; ++q)
+                {
+                    uint16x8_t half = halves[q / 2];
+                    uint32x4_t channel = vmovl_u16(q % 2 == 0 ? vget_low_u16(half) : vget_high_u16(half));
+                    uint32x4_t scale = vld1q_u32(scales + q * 4);
+
+                    // vrshrn adds the 1 << 23 rounding term before shifting.
+                    uint32x4_t lanes = vcombine_u32(
+                        vrshrn_n_u64(vmull_u32(vget_low_u32(channel), vget_low_u32(scale)), 24),
+                        vrshrn_n_u64(vmull_u32(vget_high_u32(channel), vget_high_u32(scale)), 24));
+                    narrowed[q] = vqmovn_u32(lanes);
+                }
+
+                // Saturating narrows clamp results above 255.
+                planes.val[c] = vcombine_u8(
+                    vqmovn_u16(vcombine_u16(narrowed[0], narrowed[1])),
+                    vqmovn_u16(vcombine_u16(narrowed[2], narrowed[3])));
+            }
+
+            vst4q_u8(destination + i * 4, planes);
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            const uint8_t* in = source + i * 4;
+            uint8_t* out = destination + i * 4;
+            uint64_t scale = table.scale[in[3]];
+            out[0] = static_cast<uint8_t>(std::min<uint64_t>(255, (in[0] * scale + (1u << 23)) >> 24));
+            out[1] = static_cast<uint8_t>(std::min<uint64_t>(255, (in[1] * scale + (1u << 23)) >> 24));
+            out[2] = static_cast<uint8_t>(std::min<uint64_t>(255, (in[2] * scale + (1u << 23)) >> 24));
+            out[3] = in[3];
+        }
+    }
+
+    void ForceOpaquePixels(const uint8_t* source, uint8_t* destination, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(ATEM_BRIDGE_SSE2)
+        const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_or_si128(packed, opaque));
+        }
+#elif defined(ATEM_BRIDGE_NEON)
+        const uint32x4_t opaque = vdupq_n_u32(0xFF000000u);
+        for (; i + 4 <= pixels; i += 4)
+        {
+            uint32x4_t packed = vreinterpretq_u32_u8(vld1q_u8(source + i * 4));
+            vst1q_u8(destination + i * 4, vreinterpretq_u8_u32(vorrq_u32(packed, opaque)));
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            std::memcpy(destination + i * 4, source + i * 4, 3);
+            destination[i * 4 + 3] = 255;
+        }
+    }
+
+    // Writes an opaque premultiplied fill and an opaque grey key from one read of the source.
+    void SplitFillKeyPixels(const uint8_t* source, uint8_t* fill, uint8_t* key, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(ATEM_BRIDGE_SSE2)
+        const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(fill + i * 4), _mm_or_si128(PremultiplyBlock(packed), opaque));
+
+            __m128i alpha = _mm_srli_epi32(packed, 24);
+            __m128i grey = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(alpha, 8), _mm_slli_epi32(alpha, 16)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(key + i * 4), _mm_or_si128(grey, opaque));
+        }
+#elif defined(ATEM_BRIDGE_NEON)
+        const uint8x16_t opaque = vdupq_n_u8(255);
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x4_t planes = vld4q_u8(source + i * 4);
+            uint8x16x4_t key_planes = { { planes.val[3], planes.val[3], planes.val[3], opaque } };
+            PremultiplyPlanes(planes);
+            planes.val[3] = opaque;
+            vst4q_u8(fill + i * 4, planes);
+            vst4q_u8(key + i * 4, key_planes);
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            const uint8_t* in = source + i * 4;
+            uint32_t alpha = in[3];
+            fill[i * 4] = MultiplyAlpha(in[0], alpha);
+            fill[i * 4 + 1] = MultiplyAlpha(in[1], alpha);
+            fill[i * 4 + 2] = MultiplyAlpha(in[2], alpha);
+            fill[i * 4 + 3] = 255;
+            key[i * 4] = static_cast<uint8_t>(alpha);
+            key[i * 4 + 1] = static_cast<uint8_t>(alpha);
+            key[i * 4 + 2] = static_cast<uint8_t>(alpha);
+            key[i * 4 + 3] = 255;
+        }
+    }
+
+    bool CopyPixels(int32_t alpha_mode, const uint8_t* source, uint8_t* destination, size_t pixels)
+    {
+        switch (alpha_mode)
+        {
+            case ATEM_ALPHA_MODE_STRAIGHT:
+                std::memcpy(destination, source, pixels * kBytesPerPixel);
+                return true;
+            case ATEM_ALPHA_MODE_PREMULTIPLY:
+                PremultiplyPixels(source, destination, pixels);
+                return true;
+            case ATEM_ALPHA_MODE_UNPREMULTIPLY:
+                UnpremultiplyPixels(source, destination, pixels);
+                return true;
+            case ATEM_ALPHA_MODE_OPAQUE:
+                ForceOpaquePixels(source, destination, pixels);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool IsValidPixelBuffer(const uint8_t* bgra_pixels, int32_t pixel_count, int32_t width, int32_t height)
+    {
+        return bgra_pixels != nullptr && width > 0 && height > 0
+            && static_cast<int64_t>(pixel_count) == static_cast<int64_t>(width) * height * kBytesPerPixel;
+    }
+
+    int32_t CreateUploadFrame(
+        atem_connection* connection,
+        int32_t width,
+        int32_t height,
+        IBMDSwitcherFrame** out_frame,
+        void** out_bytes,
+        char* error_buffer,
+        int32_t error_buffer_len)
+    {
+        IBMDSwitcherFrame* frame = nullptr;
+        HRESULT hr = connection->media_pool->CreateFrame(
+            bmdSwitcherPixelFormat8BitARGB,
+            static_cast<uint32_t>(width),
+            static_cast<uint32_t>(height),
+            &frame);
+
+        if (FAILED(hr) || frame == nullptr)
+        {
+            SetErrorFromHResult(error_buffer, error_buffer_len, "CreateFrame", hr);
+            return static_cast<int32_t>(hr);
+        }
+
+        void* bytes = nullptr;
+        hr = frame->GetBytes(&bytes);
+        if (FAILED(hr) || bytes == nullptr)
+        {
+            frame->Release();
+            SetErrorFromHResult(error_buffer, error_buffer_len, "GetBytes", hr);
+            return static_cast<int32_t>(hr);
+        }
+
+        *out_frame = frame;
+        *out_bytes = bytes;
+        return kSuccess;
+    }
+
+    // Locks the still pool, uploads the frame into the slot and waits for the transfer
+    // to complete. The caller keeps ownership of the frame.
+    int32_t UploadFrame(
+        atem_connection* connection,
+        int32_t slot_zero_based,
+        const char* name,
+        IBMDSwitcherFrame* frame,
+        char* error_buffer,
+        int32_t error_buffer_len)
+    {
+        auto* lock_callback = new UploadLockCallback();
+        auto* stills_callback = new UploadStillsCallback();
+
+        HRESULT hr = connection->stills->AddCallback(stills_callback);
+        if (FAILED(hr))
+        {
+            stills_callback->Release();
+            lock_callback->Release();
+            SetErrorFromHResult(error_buffer, error_buffer_len, "AddCallback", hr);
+            return static_cast<int32_t>(hr);
+        }
+
+        hr = connection->stills->Lock(lock_callback);
+        if (FAILED(hr))
+        {
+            connection->stills->RemoveCallback(stills_callback);
+            stills_callback->Release();
+            lock_callback->Release();
+            SetErrorFromHResult(error_buffer, error_buffer_len, "Lock", hr);
+            return static_cast<int32_t>(hr);
+        }
+
+        if (!lock_callback->WaitForObtained(std::chrono::seconds(5)))
+        {
+            connection->stills->RemoveCallback(stills_callback);
+            connection->stills->Unlock(lock_callback);
+            stills_callback->Release();
+            lock_callback->Release();
+            SetError(error_buffer, error_buffer_len, "timed out waiting for media pool lock");
+            return kTimeoutError;
+        }
+
+        CFStringRef name_cf = Utf8ToCFString(name != nullptr ? name : "upload");
+        hr = connection->stills->Upload(static_cast<uint32_t>(slot_zero_based), name_cf, frame);
+        if (name_cf != nullptr)
+        {
+            CFRelease(name_cf);
+        }
+
+        if (FAILED(hr))
+        {
+            connection->stills->RemoveCallback(stills_callback);
+            connection->stills->Unlock(lock_callback);
+            stills_callback->Release();
+            lock_callback->Release();
+            SetErrorFromHResult(error_buffer, error_buffer_len, "Upload", hr);
+            return static_cast<int32_t>(hr);
+        }
+
+        if (!stills_callback->WaitForCompleted(std::chrono::seconds(60)))
+        {
+            connection->stills->CancelTransfer();
+            connection->stills->RemoveCallback(stills_callback);
+            connection->stills->Unlock(lock_callback);
+            stills_callback->Release();
+            lock_callback->Release();
+            SetError(error_buffer, error_buffer_len, "timed out waiting for upload completion");
+            return kTimeoutError;
+        }
+
+        connection->stills->RemoveCallback(stills_callback);
+        connection->stills->Unlock(lock_callback);
+
+        stills_callback->Release();
+        lock_callback->Release();
+
+        return kSuccess;
+    }
+
+    bool WriteAll(int fd, const void* data, size_t length)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        while (length > 0)
+        {
+            ssize_t written = ::write(fd, bytes, length);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            bytes += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool ReadAll(int fd, void* data, size_t length)
+    {
+        auto* bytes = static_cast<uint8_t*>(data);
+        while (length > 0)
+        {
+            ssize_t count = ::read(fd, bytes, length);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                return false;
+            }
+            bytes += count;
+            length -= static_cast<size_t>(count);
+        }
+        return true;
+    }
 }
 
 int32_t atem_connect(
@@ -510,9 +986,17 @@ int32_t atem_get_stills(
         out_items[i].media_player = 0;
         out_items[i].name[0] = '\0';
         out_items[i].hash[0] = '\0';
+        out_items[i].valid = 0;
 
         CFStringRef name = nullptr;
         BMDSwitcherHash hash{};
+        bool valid = false;
+
+        hr = connection->stills->IsValid(static_cast<uint32_t>(i), &valid);
+        if (SUCCEEDED(hr))
+        {
+            out_items[i].valid = valid ? 1 : 0;
+        }
 
         hr = connection->stills->GetName(static_cast<uint32_t>(i), &name);
         if (SUCCEEDED(hr) && name != nullptr)
@@ -579,12 +1063,43 @@ int32_t atem_upload_still_bgra(
     char* error_buffer,
     int32_t error_buffer_len)
 {
-    if (bgra_pixels == nullptr || pixel_count <= 0 || width <= 0 || height <= 0)
+    return atem_upload_still_bgra_alpha(
+        connection,
+        slot_zero_based,
+        name,
+        bgra_pixels,
+        pixel_count,
+        width,
+        height,
+        ATEM_ALPHA_MODE_STRAIGHT,
+        error_buffer,
+        error_buffer_len);
+}
+
+int32_t atem_upload_still_bgra_alpha(
+    atem_connection* connection,
+    int32_t slot_zero_based,
+    const char* name,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    int32_t alpha_mode,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (!IsValidPixelBuffer(bgra_pixels, pixel_count, width, height))
     {
         SetError(error_buffer, error_buffer_len, "invalid pixel buffer");
         return kInternalError;
     }
 
+    if (alpha_mode < ATEM_ALPHA_MODE_STRAIGHT || alpha_mode > ATEM_ALPHA_MODE_OPAQUE)
+    {
+        SetError(error_buffer, error_buffer_len, "invalid alpha mode");
+        return kInternalError;
+    }
+
     int32_t status = EnsureConnection(connection, error_buffer, error_buffer_len);
     if (status != kSuccess)
     {
@@ -592,100 +1107,449 @@ int32_t atem_upload_still_bgra(
     }
 
     IBMDSwitcherFrame* frame = nullptr;
-    HRESULT hr = connection->media_pool->CreateFrame(
-        bmdSwitcherPixelFormat8BitARGB,
-        static_cast<uint32_t>(width),
-        static_cast<uint32_t>(height),
-        &frame);
+    void* destination = nullptr;
+    status = CreateUploadFrame(connection, width, height, &frame, &destination, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        return status;
+    }
+
+    CopyPixels(alpha_mode, bgra_pixels, static_cast<uint8_t*>(destination), static_cast<size_t>(width) * height);
 
-    if (FAILED(hr) || frame == nullptr)
+    status = UploadFrame(connection, slot_zero_based, name, frame, error_buffer, error_buffer_len);
+    frame->Release();
+    return status;
+}
+
+int32_t atem_upload_still_fill_key(
+    atem_connection* connection,
+    int32_t fill_slot_zero_based,
+    int32_t key_slot_zero_based,
+    const char* name,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (!IsValidPixelBuffer(bgra_pixels, pixel_count, width, height))
     {
-        SetErrorFromHResult(error_buffer, error_buffer_len, "CreateFrame", hr);
-        return static_cast<int32_t>(hr);
+        SetError(error_buffer, error_buffer_len, "invalid pixel buffer");
+        return kInternalError;
     }
 
-    void* destination = nullptr;
-    hr = frame->GetBytes(&destination);
-    if (FAILED(hr) || destination == nullptr)
+    if (fill_slot_zero_based == key_slot_zero_based)
     {
-        frame->Release();
-        SetErrorFromHResult(error_buffer, error_buffer_len, "GetBytes", hr);
-        return static_cast<int32_t>(hr);
+        SetError(error_buffer, error_buffer_len, "fill and key slots must differ");
+        return kInternalError;
+    }
+
+    int32_t status = EnsureConnection(connection, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        return status;
+    }
+
+    IBMDSwitcherFrame* fill_frame = nullptr;
+    void* fill_bytes = nullptr;
+    status = CreateUploadFrame(connection, width, height, &fill_frame, &fill_bytes, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        return status;
     }
 
-    std::memcpy(destination, bgra_pixels, static_cast<size_t>(pixel_count));
+    IBMDSwitcherFrame* key_frame = nullptr;
+    void* key_bytes = nullptr;
+    status = CreateUploadFrame(connection, width, height, &key_frame, &key_bytes, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        fill_frame->Release();
+        return status;
+    }
 
-    auto* lock_callback = new UploadLockCallback();
-    auto* stills_callback = new UploadStillsCallback();
+    SplitFillKeyPixels(bgra_pixels, static_cast<uint8_t*>(fill_bytes), static_cast<uint8_t*>(key_bytes), static_cast<size_t>(width) * height);
 
-    hr = connection->stills->AddCallback(stills_callback);
-    if (FAILED(hr))
+    std::string base_name = name != nullptr ? name : "upload";
+    std::string fill_name = base_name + " Fill";
+    std::string key_name = base_name + " Key";
+
+    status = UploadFrame(connection, fill_slot_zero_based, fill_name.c_str(), fill_frame, error_buffer, error_buffer_len);
+    if (status == kSuccess)
     {
-        frame->Release();
-        stills_callback->Release();
-        lock_callback->Release();
-        SetErrorFromHResult(error_buffer, error_buffer_len, "AddCallback", hr);
-        return static_cast<int32_t>(hr);
+        status = UploadFrame(connection, key_slot_zero_based, key_name.c_str(), key_frame, error_buffer, error_buffer_len);
     }
 
-    hr = connection->stills->Lock(lock_callback);
-    if (FAILED(hr))
+    fill_frame->Release();
+    key_frame->Release();
+    return status;
+}
+
+int32_t atem_write_frame_file(
+    const char* path,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    int32_t video_mode,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (path == nullptr || path[0] == '\0')
     {
-        connection->stills->RemoveCallback(stills_callback);
-        frame->Release();
-        stills_callback->Release();
-        lock_callback->Release();
-        SetErrorFromHResult(error_buffer, error_buffer_len, "Lock", hr);
-        return static_cast<int32_t>(hr);
+        SetError(error_buffer, error_buffer_len, "path must not be empty");
+        return kInternalError;
     }
 
-    if (!lock_callback->WaitForObtained(std::chrono::seconds(5)))
+    if (!IsValidPixelBuffer(bgra_pixels, pixel_count, width, height))
     {
-        connection->stills->RemoveCallback(stills_callback);
-        connection->stills->Unlock(lock_callback);
-        frame->Release();
-        stills_callback->Release();
-        lock_callback->Release();
-        SetError(error_buffer, error_buffer_len, "timed out waiting for media pool lock");
-        return kTimeoutError;
+        SetError(error_buffer, error_buffer_len, "invalid pixel buffer");
+        return kInternalError;
     }
 
-    CFStringRef name_cf = Utf8ToCFString(name != nullptr ? name : "upload");
-    hr = connection->stills->Upload(static_cast<uint32_t>(slot_zero_based), name_cf, frame);
-    if (name_cf != nullptr)
+    atem_frame_file_header header{};
+    std::memcpy(header.magic, ATEM_FRAME_FILE_MAGIC, sizeof(header.magic));
+    header.version = ATEM_FRAME_FILE_VERSION;
+    header.header_size = sizeof(atem_frame_file_header);
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.pixel_format = static_cast<uint32_t>(bmdSwitcherPixelFormat8BitARGB);
+    header.video_mode = video_mode;
+    header.payload_offset = ATEM_FRAME_FILE_ALIGNMENT;
+    header.payload_size = static_cast<uint64_t>(pixel_count);
+
+    Md5 md5;
+    md5.Update(bgra_pixels, static_cast<size_t>(pixel_count));
+    md5.Final(header.hash);
+
+    // Write to a uniquely named file beside the destination and rename, so readers
+    // never map a partial file and concurrent writers never share a temp file.
+    std::string temp_path = std::string(path) + ".XXXXXX";
+    int fd = ::mkstemp(&temp_path[0]);
+    if (fd < 0)
     {
-        CFRelease(name_cf);
+        SetError(error_buffer, error_buffer_len, "unable to create frame file");
+        return kInternalError;
     }
 
-    if (FAILED(hr))
+    std::string padding(static_cast<size_t>(header.payload_offset) - sizeof(header), '\0');
+    bool ok = ::fchmod(fd, 0644) == 0
+        && WriteAll(fd, &header, sizeof(header))
+        && WriteAll(fd, padding.data(), padding.size())
+        && WriteAll(fd, bgra_pixels, static_cast<size_t>(pixel_count));
+
+    if (::close(fd) != 0)
     {
-        connection->stills->RemoveCallback(stills_callback);
-        connection->stills->Unlock(lock_callback);
-        frame->Release();
-        stills_callback->Release();
-        lock_callback->Release();
-        SetErrorFromHResult(error_buffer, error_buffer_len, "Upload", hr);
-        return static_cast<int32_t>(hr);
+        ok = false;
     }
 
-    if (!stills_callback->WaitForCompleted(std::chrono::seconds(60)))
+    if (!ok || ::rename(temp_path.c_str(), path) != 0)
     {
-        connection->stills->CancelTransfer();
-        connection->stills->RemoveCallback(stills_callback);
-        connection->stills->Unlock(lock_callback);
-        frame->Release();
-        stills_callback->Release();
-        lock_callback->Release();
-        SetError(error_buffer, error_buffer_len, "timed out waiting for upload completion");
-        return kTimeoutError;
+        ::unlink(temp_path.c_str());
+        SetError(error_buffer, error_buffer_len, "failed to write frame file");
+        return kInternalError;
+    }
+
+    return kSuccess;
+}
+
+int32_t atem_upload_still_mapped(
+    atem_connection* connection,
+    int32_t slot_zero_based,
+    const char* name,
+    const char* path,
+    int32_t* out_skipped,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (out_skipped != nullptr)
+    {
+        *out_skipped = 0;
+    }
+
+    if (path == nullptr || path[0] == '\0')
+    {
+        SetError(error_buffer, error_buffer_len, "path must not be empty");
+        return kInternalError;
+    }
+
+    int32_t status = EnsureConnection(connection, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        return status;
+    }
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        SetError(error_buffer, error_buffer_len, "unable to open frame file");
+        return kInternalError;
+    }
+
+    atem_frame_file_header header{};
+    struct stat file_info{};
+    if (!ReadAll(fd, &header, sizeof(header)) || ::fstat(fd, &file_info) != 0)
+    {
+        ::close(fd);
+        SetError(error_buffer, error_buffer_len, "unable to read frame file header");
+        return kInternalError;
+    }
+
+    long page_size = ::sysconf(_SC_PAGESIZE);
+    if (std::memcmp(header.magic, ATEM_FRAME_FILE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != ATEM_FRAME_FILE_VERSION
+        || header.header_size != sizeof(atem_frame_file_header)
+        || header.pixel_format != static_cast<uint32_t>(bmdSwitcherPixelFormat8BitARGB)
+        || header.payload_size != static_cast<uint64_t>(header.width) * header.height * kBytesPerPixel
+        || header.payload_offset < header.header_size
+        || header.payload_offset + header.payload_size > static_cast<uint64_t>(file_info.st_size)
+        || (page_size > 0 && header.payload_offset % static_cast<uint64_t>(page_size) != 0))
+    {
+        ::close(fd);
+        SetError(error_buffer, error_buffer_len, "not a valid frame file");
+        return kInternalError;
+    }
+
+    int32_t width = 0;
+    int32_t height = 0;
+    status = atem_get_video_dimensions(connection, &width, &height, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        ::close(fd);
+        return status;
+    }
+
+    if (header.width != static_cast<uint32_t>(width) || header.height != static_cast<uint32_t>(height))
+    {
+        ::close(fd);
+        char message[160];
+        std::snprintf(message, sizeof(message), "frame file is %ux%u but the switcher is %dx%d", header.width, header.height, width, height);
+        SetError(error_buffer, error_buffer_len, message);
+        return kInternalError;
+    }
+
+    // The slot is unchanged if it still reports the hash seen after this file's
+    // payload was last uploaded to it. The header hash is also compared directly,
+    // which only matches if the SDK hashes stills as MD5 of the uploaded frame; that
+    // is not documented, so it may never match on real hardware.
+    BMDSwitcherHash current_hash{};
+    HRESULT hr = connection->stills->GetHash(static_cast<uint32_t>(slot_zero_based), &current_hash);
+    bool unchanged = false;
+    if (SUCCEEDED(hr))
+    {
+        std::lock_guard<std::mutex> lock(connection->mapped_mutex);
+        auto recorded = connection->mapped_uploads.find(slot_zero_based);
+        unchanged = std::memcmp(current_hash.data, header.hash, sizeof(header.hash)) == 0
+            || (recorded != connection->mapped_uploads.end()
+                && std::memcmp(recorded->second.payload_hash, header.hash, sizeof(header.hash)) == 0
+                && std::memcmp(recorded->second.switcher_hash.data, current_hash.data, sizeof(current_hash.data)) == 0);
+    }
+
+    if (unchanged)
+    {
+        ::close(fd);
+        if (out_skipped != nullptr)
+        {
+            *out_skipped = 1;
+        }
+        return kSuccess;
+    }
+
+    size_t payload_size = static_cast<size_t>(header.payload_size);
+    void* mapping = ::mmap(nullptr, payload_size, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(header.payload_offset));
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        SetError(error_buffer, error_buffer_len, "unable to map frame file");
+        return kInternalError;
     }
 
-    connection->stills->RemoveCallback(stills_callback);
-    connection->stills->Unlock(lock_callback);
+    ::madvise(mapping, payload_size, MADV_SEQUENTIAL);
 
+    IBMDSwitcherFrame* frame = nullptr;
+    void* destination = nullptr;
+    status = CreateUploadFrame(connection, width, height, &frame, &destination, error_buffer, error_buffer_len);
+    if (status != kSuccess)
+    {
+        ::munmap(mapping, payload_size);
+        return status;
+    }
+
+    std::memcpy(destination, mapping, payload_size);
+    ::munmap(mapping, payload_size);
+
+    status = UploadFrame(connection, slot_zero_based, name, frame, error_buffer, error_buffer_len);
     frame->Release();
-    stills_callback->Release();
-    lock_callback->Release();
+
+    if (status == kSuccess)
+    {
+        atem_mapped_upload uploaded{};
+        std::memcpy(uploaded.payload_hash, header.hash, sizeof(header.hash));
+        hr = connection->stills->GetHash(static_cast<uint32_t>(slot_zero_based), &uploaded.switcher_hash);
+
+        std::lock_guard<std::mutex> lock(connection->mapped_mutex);
+        if (SUCCEEDED(hr))
+        {
+            connection->mapped_uploads[slot_zero_based] = uploaded;
+        }
+        else
+        {
+            connection->mapped_uploads.erase(slot_zero_based);
+        }
+    }
+
+    return status;
+}
+
+int32_t atem_frame_buffer_create(
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    atem_frame_buffer** out_buffer,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (out_buffer == nullptr)
+    {
+        SetError(error_buffer, error_buffer_len, "out_buffer must not be null");
+        return kInternalError;
+    }
+
+    *out_buffer = nullptr;
+
+    if (!IsValidPixelBuffer(bgra_pixels, pixel_count, width, height))
+    {
+        SetError(error_buffer, error_buffer_len, "invalid pixel buffer");
+        return kInternalError;
+    }
+
+    auto* buffer = new atem_frame_buffer();
+    buffer->width = width;
+    buffer->height = height;
+    buffer->size = static_cast<size_t>(pixel_count);
+    buffer->pixels.reset(new uint8_t[buffer->size]);
+    std::memcpy(buffer->pixels.get(), bgra_pixels, buffer->size);
+
+    *out_buffer = buffer;
+    return kSuccess;
+}
+
+void atem_frame_buffer_retain(atem_frame_buffer* buffer)
+{
+    if (buffer != nullptr)
+    {
+        buffer->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void atem_frame_buffer_release(atem_frame_buffer* buffer)
+{
+    if (buffer != nullptr && buffer->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete buffer;
+    }
+}
+
+int32_t atem_upload_still_fanout(
+    atem_connection** connections,
+    atem_frame_buffer** buffers,
+    int32_t count,
+    int32_t slot_zero_based,
+    const char* name,
+    atem_fanout_result* out_results,
+    char* error_buffer,
+    int32_t error_buffer_len)
+{
+    if (connections == nullptr || buffers == nullptr || out_results == nullptr || count <= 0)
+    {
+        SetError(error_buffer, error_buffer_len, "invalid fan-out arguments");
+        return kInternalError;
+    }
+
+    std::string name_copy = name != nullptr ? name : "upload";
+
+    auto upload_one = [&](int32_t index) {
+        atem_fanout_result& result = out_results[index];
+        result.error[0] = '\0';
+        result.latency_ms = 0.0;
+
+        atem_connection* connection = connections[index];
+        atem_frame_buffer* buffer = buffers[index];
+        if (buffer == nullptr)
+        {
+            SetError(result.error, sizeof(result.error), "no frame buffer for connection");
+            result.status = kInternalError;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        result.status = EnsureConnection(connection, result.error, sizeof(result.error));
+        if (result.status != kSuccess)
+        {
+            return;
+        }
+
+        IBMDSwitcherFrame* frame = nullptr;
+        void* destination = nullptr;
+        result.status = CreateUploadFrame(connection, buffer->width, buffer->height, &frame, &destination, result.error, sizeof(result.error));
+        if (result.status == kSuccess)
+        {
+            std::memcpy(destination, buffer->pixels.get(), buffer->size);
+            result.status = UploadFrame(connection, slot_zero_based, name_copy.c_str(), frame, result.error, sizeof(result.error));
+            frame->Release();
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        result.latency_ms = elapsed.count();
+    };
+
+    // Each worker holds its own reference so a buffer outlives every upload using it.
+    for (int32_t i = 0; i < count; ++i)
+    {
+        atem_frame_buffer_retain(buffers[i]);
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(count - 1));
+    for (int32_t i = 1; i < count; ++i)
+    {
+        // Exceptions must not cross the C boundary; if no thread can be started,
+        // that upload runs here instead.
+        try
+        {
+            workers.emplace_back(upload_one, i);
+        }
+        catch (const std::system_error&)
+        {
+            upload_one(i);
+        }
+    }
+    upload_one(0);
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    int32_t failed = 0;
+    for (int32_t i = 0; i < count; ++i)
+    {
+        atem_frame_buffer_release(buffers[i]);
+        if (out_results[i].status != kSuccess)
+        {
+            failed++;
+        }
+    }
+
+    if (failed > 0)
+    {
+        char message[96];
+        std::snprintf(message, sizeof(message), "%d of %d uploads failed", failed, count);
+        SetError(error_buffer, error_buffer_len, message);
+        return kInternalError;
+    }
 
     return kSuccess;
 }
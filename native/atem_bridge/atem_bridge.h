@@ -17,6 +17,7 @@ extern "C" {
 #endif
 
 typedef struct atem_connection atem_connection;
+typedef struct atem_frame_buffer atem_frame_buffer;
 
 typedef struct atem_still_info
 {
@@ -24,8 +25,53 @@ typedef struct atem_still_info
     int32_t media_player;
     char name[128];
     char hash[33];
+    int32_t valid;
 } atem_still_info;
 
+#define ATEM_FRAME_FILE_MAGIC "ATEMFRM1"
+#define ATEM_FRAME_FILE_VERSION 1
+#define ATEM_FRAME_FILE_ALIGNMENT 16384
+
+/*
+ * Pre-rendered still frame on disk. The header is followed by zero padding up to
+ * payload_offset (a multiple of ATEM_FRAME_FILE_ALIGNMENT, so the payload can be
+ * mapped directly on 4K and 16K page systems) and then width * height * 4 bytes of
+ * frame data in the switcher's 8-bit ARGB layout (BGRA byte order). hash is the MD5
+ * of the payload. video_mode is -1 when the frame was rendered without a switcher.
+ */
+typedef struct atem_frame_file_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixel_format;
+    int32_t video_mode;
+    uint64_t payload_offset;
+    uint64_t payload_size;
+    uint8_t hash[16];
+} atem_frame_file_header;
+
+/*
+ * How alpha is treated when the BGRA pixels are copied into the switcher frame.
+ * The switcher's keyers expect premultiplied content; decoders produce straight alpha.
+ */
+typedef enum atem_alpha_mode
+{
+    ATEM_ALPHA_MODE_STRAIGHT = 0,
+    ATEM_ALPHA_MODE_PREMULTIPLY = 1,
+    ATEM_ALPHA_MODE_UNPREMULTIPLY = 2,
+    ATEM_ALPHA_MODE_OPAQUE = 3,
+} atem_alpha_mode;
+
+typedef struct atem_fanout_result
+{
+    double latency_ms;
+    int32_t status;
+    char error[256];
+} atem_fanout_result;
+
 ATEM_BRIDGE_API int32_t atem_connect(
     const char* device_address,
     atem_connection** out_connection,
@@ -74,6 +120,92 @@ ATEM_BRIDGE_API int32_t atem_upload_still_bgra(
     char* error_buffer,
     int32_t error_buffer_len);
 
+ATEM_BRIDGE_API int32_t atem_upload_still_bgra_alpha(
+    atem_connection* connection,
+    int32_t slot_zero_based,
+    const char* name,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    int32_t alpha_mode,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
+/*
+ * Splits straight-alpha BGRA pixels into an opaque, premultiplied fill still and an
+ * opaque luma key still (alpha as grey), uploaded to two slots for use with a luma keyer.
+ */
+ATEM_BRIDGE_API int32_t atem_upload_still_fill_key(
+    atem_connection* connection,
+    int32_t fill_slot_zero_based,
+    int32_t key_slot_zero_based,
+    const char* name,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
+ATEM_BRIDGE_API int32_t atem_write_frame_file(
+    const char* path,
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    int32_t video_mode,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
+/*
+ * Uploads a frame file. The upload is skipped (out_skipped = 1) when the slot still
+ * reports the hash it had after this connection last uploaded the same payload
+ * there, or when the slot's hash equals the file's MD5, which depends on how the SDK
+ * hashes stills and is not guaranteed.
+ */
+ATEM_BRIDGE_API int32_t atem_upload_still_mapped(
+    atem_connection* connection,
+    int32_t slot_zero_based,
+    const char* name,
+    const char* path,
+    int32_t* out_skipped,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
+/*
+ * Read-only, reference-counted copy of a converted BGRA frame that can be uploaded
+ * to many switchers. The buffer is created with a reference count of one.
+ */
+ATEM_BRIDGE_API int32_t atem_frame_buffer_create(
+    const uint8_t* bgra_pixels,
+    int32_t pixel_count,
+    int32_t width,
+    int32_t height,
+    atem_frame_buffer** out_buffer,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
+ATEM_BRIDGE_API void atem_frame_buffer_retain(atem_frame_buffer* buffer);
+
+ATEM_BRIDGE_API void atem_frame_buffer_release(atem_frame_buffer* buffer);
+
+/*
+ * Uploads buffers[i] to connections[i] for every i, one thread per connection.
+ * Connections running the same resolution can share a buffer. Each connection's
+ * status, error and latency are written to out_results[i]; the call fails if any
+ * upload failed.
+ */
+ATEM_BRIDGE_API int32_t atem_upload_still_fanout(
+    atem_connection** connections,
+    atem_frame_buffer** buffers,
+    int32_t count,
+    int32_t slot_zero_based,
+    const char* name,
+    atem_fanout_result* out_results,
+    char* error_buffer,
+    int32_t error_buffer_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,444 @@
+#include "atem_bridge.h"
+#include "stub_sdk.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BMDSwitcherAPI.h"
+
+// Micro-benchmarks for the bridge's CPU-side paths, run against the stub SDK so
+// no switcher (or ATEM SDK) is needed. Results are printed as a table and can be
+// written as JSON with --json <path> for comparison between commits.
+
+namespace
+{
+    std::atomic<uint64_t> g_allocation_count{0};
+    std::atomic<uint64_t> g_allocation_bytes{0};
+
+    constexpr int32_t kErrorBufferLength = 1024;
+    constexpr double kMinSampleSeconds = 0.02;
+
+    struct Resolution
+    {
+        const char* name;
+        int32_t width;
+        int32_t height;
+        BMDSwitcherVideoMode video_mode;
+    };
+
+    constexpr Resolution kResolutions[] = {
+        { "SD", 720, 480, bmdSwitcherVideoMode525i5994NTSC },
+        { "720p", 1280, 720, bmdSwitcherVideoMode720p50 },
+        { "1080p", 1920, 1080, bmdSwitcherVideoMode1080p25 },
+        { "4K", 3840, 2160, bmdSwitcherVideoMode4KHDp25 },
+    };
+
+    constexpr int32_t kStillCounts[] = { 20, 64 };
+    constexpr int32_t kFanoutConnections = 4;
+
+    struct Options
+    {
+        std::string json_path;
+        std::string filter;
+        int samples = 15;
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string variant;
+        uint64_t bytes_per_op = 0;
+        uint64_t iterations = 0;
+        double median_ns = 0.0;
+        double min_ns = 0.0;
+        double allocations_per_op = 0.0;
+        double allocated_bytes_per_op = 0.0;
+
+        double GigabytesPerSecond() const
+        {
+            return median_ns > 0.0 ? static_cast<double>(bytes_per_op) / median_ns : 0.0;
+        }
+    };
+
+    // Runs op in samples sized to at least kMinSampleSeconds each and reports the
+    // median and fastest per-op time. Allocations are counted over all samples.
+    Result Measure(const std::string& name, const std::string& variant, uint64_t bytes_per_op, int samples, const std::function<void()>& op)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        op();
+
+        uint64_t batch = 1;
+        for (;;)
+        {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < batch; ++i)
+            {
+                op();
+            }
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            if (elapsed.count() >= kMinSampleSeconds || batch >= (1u << 30))
+            {
+                break;
+            }
+            batch *= 2;
+        }
+
+        std::vector<double> per_op_ns;
+        per_op_ns.reserve(static_cast<size_t>(samples));
+
+        uint64_t allocations_before = g_allocation_count.load();
+        uint64_t bytes_before = g_allocation_bytes.load();
+
+        for (int sample = 0; sample < samples; ++sample)
+        {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < batch; ++i)
+            {
+                op();
+            }
+            std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            per_op_ns.push_back(elapsed.count() / static_cast<double>(batch));
+        }
+
+        uint64_t total_ops = batch * static_cast<uint64_t>(samples);
+        std::sort(per_op_ns.begin(), per_op_ns.end());
+
+        Result result;
+        result.name = name;
+        result.variant = variant;
+        result.bytes_per_op = bytes_per_op;
+        result.iterations = total_ops;
+        result.median_ns = per_op_ns[per_op_ns.size() / 2];
+        result.min_ns = per_op_ns.front();
+        result.allocations_per_op = static_cast<double>(g_allocation_count.load() - allocations_before) / static_cast<double>(total_ops);
+        result.allocated_bytes_per_op = static_cast<double>(g_allocation_bytes.load() - bytes_before) / static_cast<double>(total_ops);
+        return result;
+    }
+
+    void Check(int32_t status, const char* action, const char* error_buffer)
+    {
+        if (status != 0)
+        {
+            std::fprintf(stderr, "%s failed (%d): %s\n", action, status, error_buffer);
+            std::exit(1);
+        }
+    }
+
+    bool Selected(const Options& options, const std::string& name)
+    {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    std::vector<uint8_t> MakeFrame(const Resolution& resolution)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(resolution.width) * resolution.height * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            pixels[i] = static_cast<uint8_t>(i * 13 + (i >> 11));
+        }
+        return pixels;
+    }
+
+    void RunUploadBenchmarks(const Options& options, atem_connection* connection, std::vector<Result>& results)
+    {
+        char error_buffer[kErrorBufferLength] = {};
+
+        for (const Resolution& resolution : kResolutions)
+        {
+            atem_stub_set_video_mode(resolution.video_mode);
+            std::vector<uint8_t> pixels = MakeFrame(resolution);
+            int32_t pixel_count = static_cast<int32_t>(pixels.size());
+
+            if (Selected(options, "upload_still_bgra"))
+            {
+                results.push_back(Measure("upload_still_bgra", resolution.name, pixels.size(), options.samples, [&]() {
+                    Check(atem_upload_still_bgra(connection, 0, "bench", pixels.data(), pixel_count, resolution.width, resolution.height, error_buffer, kErrorBufferLength),
+                        "atem_upload_still_bgra", error_buffer);
+                }));
+            }
+
+            struct AlphaCase
+            {
+                const char* name;
+                int32_t mode;
+            };
+
+            constexpr AlphaCase kAlphaCases[] = {
+                { "upload_still_premultiply", ATEM_ALPHA_MODE_PREMULTIPLY },
+                { "upload_still_unpremultiply", ATEM_ALPHA_MODE_UNPREMULTIPLY },
+                { "upload_still_opaque", ATEM_ALPHA_MODE_OPAQUE },
+            };
+
+            for (const AlphaCase& alpha_case : kAlphaCases)
+            {
+                if (Selected(options, alpha_case.name))
+                {
+                    results.push_back(Measure(alpha_case.name, resolution.name, pixels.size(), options.samples, [&]() {
+                        Check(atem_upload_still_bgra_alpha(connection, 0, "bench", pixels.data(), pixel_count, resolution.width, resolution.height, alpha_case.mode, error_buffer, kErrorBufferLength),
+                            "atem_upload_still_bgra_alpha", error_buffer);
+                    }));
+                }
+            }
+
+            if (Selected(options, "upload_still_fill_key"))
+            {
+                results.push_back(Measure("upload_still_fill_key", resolution.name, pixels.size(), options.samples, [&]() {
+                    Check(atem_upload_still_fill_key(connection, 0, 1, "bench", pixels.data(), pixel_count, resolution.width, resolution.height, error_buffer, kErrorBufferLength),
+                        "atem_upload_still_fill_key", error_buffer);
+                }));
+            }
+
+            if (Selected(options, "upload_still_fanout"))
+            {
+                atem_frame_buffer* buffer = nullptr;
+                Check(atem_frame_buffer_create(pixels.data(), pixel_count, resolution.width, resolution.height, &buffer, error_buffer, kErrorBufferLength),
+                    "atem_frame_buffer_create", error_buffer);
+
+                std::vector<atem_connection*> connections(kFanoutConnections);
+                std::vector<atem_frame_buffer*> buffers(kFanoutConnections, buffer);
+                std::vector<atem_fanout_result> fanout_results(kFanoutConnections);
+                for (atem_connection*& fanout_connection : connections)
+                {
+                    int32_t fail_reason = 0;
+                    Check(atem_connect("stub", &fanout_connection, &fail_reason, error_buffer, kErrorBufferLength), "atem_connect", error_buffer);
+                }
+
+                std::string variant = std::string(resolution.name) + " x" + std::to_string(kFanoutConnections);
+                results.push_back(Measure("upload_still_fanout", variant, pixels.size() * kFanoutConnections, options.samples, [&]() {
+                    Check(atem_upload_still_fanout(connections.data(), buffers.data(), kFanoutConnections, 0, "bench", fanout_results.data(), error_buffer, kErrorBufferLength),
+                        "atem_upload_still_fanout", error_buffer);
+                }));
+
+                for (atem_connection* fanout_connection : connections)
+                {
+                    atem_disconnect(fanout_connection);
+                }
+                atem_frame_buffer_release(buffer);
+            }
+
+            if (Selected(options, "write_frame_file") || Selected(options, "upload_still_mapped"))
+            {
+                std::string path = std::string("atem_bridge_bench_") + resolution.name + ".atemframe";
+                Check(atem_write_frame_file(path.c_str(), pixels.data(), pixel_count, resolution.width, resolution.height, resolution.video_mode, error_buffer, kErrorBufferLength),
+                    "atem_write_frame_file", error_buffer);
+
+                if (Selected(options, "write_frame_file"))
+                {
+                    results.push_back(Measure("write_frame_file", resolution.name, pixels.size(), options.samples, [&]() {
+                        Check(atem_write_frame_file(path.c_str(), pixels.data(), pixel_count, resolution.width, resolution.height, resolution.video_mode, error_buffer, kErrorBufferLength),
+                            "atem_write_frame_file", error_buffer);
+                    }));
+                }
+
+                if (Selected(options, "upload_still_mapped"))
+                {
+                    // Alternates between two frames so the slot never already holds the
+                    // one being uploaded and every sample is a transfer.
+                    std::string other_path = std::string("atem_bridge_bench_") + resolution.name + "_other.atemframe";
+                    std::vector<uint8_t> other_pixels = pixels;
+                    other_pixels[0] ^= 0xFF;
+                    Check(atem_write_frame_file(other_path.c_str(), other_pixels.data(), pixel_count, resolution.width, resolution.height, resolution.video_mode, error_buffer, kErrorBufferLength),
+                        "atem_write_frame_file", error_buffer);
+
+                    bool use_other = false;
+                    results.push_back(Measure("upload_still_mapped", resolution.name, pixels.size(), options.samples, [&]() {
+                        int32_t skipped = 0;
+                        use_other = !use_other;
+                        Check(atem_upload_still_mapped(connection, 0, "bench", use_other ? other_path.c_str() : path.c_str(), &skipped, error_buffer, kErrorBufferLength),
+                            "atem_upload_still_mapped", error_buffer);
+                        if (skipped != 0)
+                        {
+                            std::fprintf(stderr, "atem_upload_still_mapped skipped a changed frame\n");
+                            std::exit(1);
+                        }
+                    }));
+                    std::remove(other_path.c_str());
+
+                    // The first upload fills the slot and records the hash the switcher
+                    // reports; every later one should be skipped after comparing it.
+                    int32_t primed = 0;
+                    Check(atem_upload_still_mapped(connection, 0, "bench", path.c_str(), &primed, error_buffer, kErrorBufferLength),
+                        "atem_upload_still_mapped", error_buffer);
+
+                    results.push_back(Measure("upload_still_mapped_skip", resolution.name, pixels.size(), options.samples, [&]() {
+                        int32_t skipped = 0;
+                        Check(atem_upload_still_mapped(connection, 0, "bench", path.c_str(), &skipped, error_buffer, kErrorBufferLength),
+                            "atem_upload_still_mapped", error_buffer);
+                        if (skipped == 0)
+                        {
+                            std::fprintf(stderr, "atem_upload_still_mapped did not skip an unchanged frame\n");
+                            std::exit(1);
+                        }
+                    }));
+                }
+
+                std::remove(path.c_str());
+            }
+        }
+    }
+
+    void RunStillsBenchmarks(const Options& options, atem_connection* connection, std::vector<Result>& results)
+    {
+        if (!Selected(options, "get_stills"))
+        {
+            return;
+        }
+
+        char error_buffer[kErrorBufferLength] = {};
+
+        for (int32_t count : kStillCounts)
+        {
+            atem_stub_set_still_count(count);
+            atem_stub_set_media_player_source(0, 0);
+            atem_stub_set_media_player_source(1, count - 1);
+
+            std::vector<atem_still_info> items(static_cast<size_t>(count));
+            std::string variant = std::to_string(count) + " stills";
+
+            results.push_back(Measure("get_stills", variant, items.size() * sizeof(atem_still_info), options.samples, [&]() {
+                int32_t out_count = 0;
+                Check(atem_get_stills(connection, items.data(), count, &out_count, error_buffer, kErrorBufferLength),
+                    "atem_get_stills", error_buffer);
+            }));
+        }
+    }
+
+    void PrintTable(const std::vector<Result>& results)
+    {
+        std::printf("%-28s %-10s %14s %14s %10s %12s %14s\n", "benchmark", "variant", "median ns/op", "min ns/op", "GB/s", "allocs/op", "alloc B/op");
+        for (const Result& result : results)
+        {
+            std::printf("%-28s %-10s %14.0f %14.0f %10.2f %12.2f %14.0f\n",
+                result.name.c_str(), result.variant.c_str(), result.median_ns, result.min_ns,
+                result.GigabytesPerSecond(), result.allocations_per_op, result.allocated_bytes_per_op);
+        }
+    }
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::fprintf(file, "{\n  \"benchmark\": \"atem_bridge_bench\",\n  \"sdk\": \"stub\",\n  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            std::fprintf(file,
+                "    {\"name\": \"%s\", \"variant\": \"%s\", \"bytes_per_op\": %llu, \"iterations\": %llu, "
+                "\"median_ns\": %.1f, \"min_ns\": %.1f, \"gb_per_s\": %.4f, "
+                "\"allocations_per_op\": %.3f, \"allocated_bytes_per_op\": %.1f}%s\n",
+                result.name.c_str(), result.variant.c_str(),
+                static_cast<unsigned long long>(result.bytes_per_op), static_cast<unsigned long long>(result.iterations),
+                result.median_ns, result.min_ns, result.GigabytesPerSecond(),
+                result.allocations_per_op, result.allocated_bytes_per_op,
+                i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+
+        return std::fclose(file) == 0;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--json" && i + 1 < argc)
+            {
+                options.json_path = argv[++i];
+            }
+            else if (arg == "--filter" && i + 1 < argc)
+            {
+                options.filter = argv[++i];
+            }
+            else if (arg == "--samples" && i + 1 < argc)
+            {
+                options.samples = std::max(1, std::atoi(argv[++i]));
+            }
+            else
+            {
+                std::fprintf(stderr, "Usage: atem_bridge_bench [--json <path>] [--filter <name>] [--samples <n>]\n");
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void* operator new(size_t size)
+{
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        return 2;
+    }
+
+    char error_buffer[kErrorBufferLength] = {};
+    atem_connection* connection = nullptr;
+    int32_t fail_reason = 0;
+    Check(atem_connect("stub", &connection, &fail_reason, error_buffer, kErrorBufferLength), "atem_connect", error_buffer);
+
+    std::vector<Result> results;
+    RunUploadBenchmarks(options, connection, results);
+    RunStillsBenchmarks(options, connection, results);
+
+    atem_disconnect(connection);
+
+    PrintTable(results);
+
+    if (!options.json_path.empty() && !WriteJson(options.json_path, results))
+    {
+        std::fprintf(stderr, "unable to write %s\n", options.json_path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
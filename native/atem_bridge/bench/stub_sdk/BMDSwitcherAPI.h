@@ -0,0 +1,170 @@
+#pragma once
+
+// Minimal stand-in for the ATEM SDK's BMDSwitcherAPI.h. It declares only the
+// interfaces and constants atem_bridge.cpp uses; stub_sdk.cpp provides an
+// in-memory switcher behind them.
+
+#include <stdint.h>
+
+#include <CoreFoundation/CoreFoundation.h>
+
+typedef int32_t HRESULT;
+typedef uint32_t ULONG;
+typedef void* LPVOID;
+typedef CFUUIDBytes REFIID;
+
+#define S_OK ((HRESULT) 0)
+#define S_FALSE ((HRESULT) 1)
+#define E_NOTIMPL ((HRESULT) 0x80004001)
+#define E_NOINTERFACE ((HRESULT) 0x80004002)
+#define E_POINTER ((HRESULT) 0x80004003)
+#define E_FAIL ((HRESULT) 0x80004005)
+#define E_INVALIDARG ((HRESULT) 0x80070057)
+
+#define SUCCEEDED(hr) (((HRESULT) (hr)) >= 0)
+#define FAILED(hr) (((HRESULT) (hr)) < 0)
+
+extern const REFIID IID_IBMDSwitcherMediaPool;
+extern const REFIID IID_IBMDSwitcherMediaPlayerIterator;
+
+typedef enum _BMDSwitcherVideoMode
+{
+    bmdSwitcherVideoMode525i5994NTSC = 0,
+    bmdSwitcherVideoMode625i50PAL,
+    bmdSwitcherVideoMode720p50,
+    bmdSwitcherVideoMode720p5994,
+    bmdSwitcherVideoMode720p60,
+    bmdSwitcherVideoMode1080i50,
+    bmdSwitcherVideoMode1080i5994,
+    bmdSwitcherVideoMode1080p2398,
+    bmdSwitcherVideoMode1080p24,
+    bmdSwitcherVideoMode1080p25,
+    bmdSwitcherVideoMode1080p2997,
+    bmdSwitcherVideoMode1080p50,
+    bmdSwitcherVideoMode1080p5994,
+    bmdSwitcherVideoMode1080p60,
+    bmdSwitcherVideoMode4KHDp2398,
+    bmdSwitcherVideoMode4KHDp24,
+    bmdSwitcherVideoMode4KHDp25,
+    bmdSwitcherVideoMode4KHDp2997,
+    bmdSwitcherVideoMode4KHDp30,
+    bmdSwitcherVideoMode4KHDp5994,
+} BMDSwitcherVideoMode;
+
+typedef enum _BMDSwitcherPixelFormat
+{
+    bmdSwitcherPixelFormat8BitARGB = 0x41524742,
+} BMDSwitcherPixelFormat;
+
+typedef enum _BMDSwitcherConnectToFailure
+{
+    bmdSwitcherConnectToFailureNoResponse = 1,
+    bmdSwitcherConnectToFailureIncompatibleFirmware,
+    bmdSwitcherConnectToFailureCorruptData,
+    bmdSwitcherConnectToFailureStateSync,
+    bmdSwitcherConnectToFailureStateSyncTimedOut,
+} BMDSwitcherConnectToFailure;
+
+typedef enum _BMDSwitcherMediaPoolEventType
+{
+    bmdSwitcherMediaPoolEventTypeValidChanged = 0,
+    bmdSwitcherMediaPoolEventTypeNameChanged,
+    bmdSwitcherMediaPoolEventTypeHashChanged,
+    bmdSwitcherMediaPoolEventTypeLockBusy,
+    bmdSwitcherMediaPoolEventTypeLockIdle,
+    bmdSwitcherMediaPoolEventTypeTransferCompleted,
+    bmdSwitcherMediaPoolEventTypeTransferCancelled,
+    bmdSwitcherMediaPoolEventTypeTransferFailed,
+} BMDSwitcherMediaPoolEventType;
+
+typedef enum _BMDSwitcherMediaPlayerSourceType
+{
+    bmdSwitcherMediaPlayerSourceTypeStill = 0,
+    bmdSwitcherMediaPlayerSourceTypeClip,
+} BMDSwitcherMediaPlayerSourceType;
+
+typedef struct
+{
+    uint8_t data[16];
+} BMDSwitcherHash;
+
+class IUnknown
+{
+public:
+    virtual HRESULT QueryInterface(REFIID iid, LPVOID* ppv) = 0;
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+
+protected:
+    virtual ~IUnknown() = default;
+};
+
+class IBMDSwitcherFrame : public IUnknown
+{
+public:
+    virtual HRESULT GetWidth(uint32_t* width) = 0;
+    virtual HRESULT GetHeight(uint32_t* height) = 0;
+    virtual HRESULT GetPixelFormat(BMDSwitcherPixelFormat* format) = 0;
+    virtual HRESULT GetBytes(void** buffer) = 0;
+};
+
+class IBMDSwitcherLockCallback : public IUnknown
+{
+public:
+    virtual HRESULT Obtained() = 0;
+};
+
+class IBMDSwitcherStillsCallback : public IUnknown
+{
+public:
+    virtual HRESULT Notify(BMDSwitcherMediaPoolEventType eventType, IBMDSwitcherFrame* frame, int32_t index) = 0;
+};
+
+class IBMDSwitcherStills : public IUnknown
+{
+public:
+    virtual HRESULT GetCount(uint32_t* count) = 0;
+    virtual HRESULT IsValid(uint32_t index, bool* valid) = 0;
+    virtual HRESULT GetName(uint32_t index, CFStringRef* name) = 0;
+    virtual HRESULT GetHash(uint32_t index, BMDSwitcherHash* hash) = 0;
+    virtual HRESULT Lock(IBMDSwitcherLockCallback* callback) = 0;
+    virtual HRESULT Unlock(IBMDSwitcherLockCallback* callback) = 0;
+    virtual HRESULT Upload(uint32_t index, CFStringRef name, IBMDSwitcherFrame* frame) = 0;
+    virtual HRESULT CancelTransfer() = 0;
+    virtual HRESULT AddCallback(IBMDSwitcherStillsCallback* callback) = 0;
+    virtual HRESULT RemoveCallback(IBMDSwitcherStillsCallback* callback) = 0;
+};
+
+class IBMDSwitcherMediaPool : public IUnknown
+{
+public:
+    virtual HRESULT GetStills(IBMDSwitcherStills** stills) = 0;
+    virtual HRESULT CreateFrame(BMDSwitcherPixelFormat format, uint32_t width, uint32_t height, IBMDSwitcherFrame** frame) = 0;
+};
+
+class IBMDSwitcherMediaPlayer : public IUnknown
+{
+public:
+    virtual HRESULT GetSource(BMDSwitcherMediaPlayerSourceType* type, uint32_t* index) = 0;
+    virtual HRESULT SetSource(BMDSwitcherMediaPlayerSourceType type, uint32_t index) = 0;
+};
+
+class IBMDSwitcherMediaPlayerIterator : public IUnknown
+{
+public:
+    virtual HRESULT Next(IBMDSwitcherMediaPlayer** media_player) = 0;
+};
+
+class IBMDSwitcher : public IUnknown
+{
+public:
+    virtual HRESULT GetProductName(CFStringRef* name) = 0;
+    virtual HRESULT GetVideoMode(BMDSwitcherVideoMode* mode) = 0;
+    virtual HRESULT CreateIterator(REFIID iid, LPVOID* ppv) = 0;
+};
+
+class IBMDSwitcherDiscovery : public IUnknown
+{
+public:
+    virtual HRESULT ConnectTo(CFStringRef address, IBMDSwitcher** switcher, BMDSwitcherConnectToFailure* failure) = 0;
+};
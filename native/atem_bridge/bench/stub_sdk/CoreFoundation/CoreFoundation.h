@@ -0,0 +1,41 @@
+#pragma once
+
+// Minimal CoreFoundation stand-in so the bridge builds on machines without the
+// macOS SDK. Only the calls atem_bridge.cpp makes are provided.
+
+#include <stdint.h>
+
+typedef long CFIndex;
+typedef uint32_t CFStringEncoding;
+typedef const struct __CFAllocator* CFAllocatorRef;
+typedef const struct __CFString* CFStringRef;
+typedef const struct __CFURL* CFURLRef;
+typedef struct __CFBundle* CFBundleRef;
+typedef const void* CFTypeRef;
+
+typedef enum
+{
+    kCFURLPOSIXPathStyle = 0,
+} CFURLPathStyle;
+
+typedef struct
+{
+    uint8_t bytes[16];
+} CFUUIDBytes;
+
+#define kCFAllocatorDefault ((CFAllocatorRef) nullptr)
+#define kCFStringEncodingUTF8 ((CFStringEncoding) 0x08000100)
+
+CFStringRef CFStringCreateWithCString(CFAllocatorRef allocator, const char* value, CFStringEncoding encoding);
+CFIndex CFStringGetLength(CFStringRef value);
+CFIndex CFStringGetMaximumSizeForEncoding(CFIndex length, CFStringEncoding encoding);
+bool CFStringGetCString(CFStringRef value, char* buffer, CFIndex buffer_size, CFStringEncoding encoding);
+CFStringRef __CFStringMakeConstantString(const char* value);
+
+CFURLRef CFURLCreateWithFileSystemPath(CFAllocatorRef allocator, CFStringRef path, CFURLPathStyle style, bool is_directory);
+CFBundleRef CFBundleCreate(CFAllocatorRef allocator, CFURLRef url);
+void* CFBundleGetFunctionPointerForName(CFBundleRef bundle, CFStringRef name);
+
+void CFRelease(CFTypeRef value);
+
+#define CFSTR(value) __CFStringMakeConstantString(value)
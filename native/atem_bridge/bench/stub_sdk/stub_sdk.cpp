@@ -0,0 +1,585 @@
+#include "stub_sdk.h"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <CoreFoundation/CoreFoundation.h>
+
+#include "BMDSwitcherAPI.h"
+#include "md5.h"
+
+const REFIID IID_IBMDSwitcherMediaPool = { { 0x53, 0x54, 0x55, 0x42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 } };
+const REFIID IID_IBMDSwitcherMediaPlayerIterator = { { 0x53, 0x54, 0x55, 0x42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2 } };
+
+struct StubCFObject
+{
+    virtual ~StubCFObject() = default;
+};
+
+struct __CFString : StubCFObject
+{
+    explicit __CFString(std::string text) : value(std::move(text)) {}
+    std::string value;
+};
+
+struct __CFURL : StubCFObject
+{
+    explicit __CFURL(std::string text) : path(std::move(text)) {}
+    std::string path;
+};
+
+struct __CFBundle : StubCFObject
+{
+};
+
+namespace
+{
+    constexpr char kDiscoveryEntryPoint[] = "GetBMDSwitcherDiscoveryInstance_0012";
+    constexpr uint32_t kDefaultStillCount = 20;
+    constexpr int32_t kMediaPlayerCount = 2;
+
+    bool SameIid(const REFIID& left, const REFIID& right)
+    {
+        return std::memcmp(left.bytes, right.bytes, sizeof(left.bytes)) == 0;
+    }
+
+    struct StillSlot
+    {
+        bool valid = false;
+        std::string name;
+        BMDSwitcherHash hash{};
+    };
+
+    struct MediaPlayerState
+    {
+        BMDSwitcherMediaPlayerSourceType type = bmdSwitcherMediaPlayerSourceTypeStill;
+        uint32_t index = 0;
+    };
+
+    struct StubState
+    {
+        std::mutex mutex;
+        BMDSwitcherVideoMode video_mode = bmdSwitcherVideoMode1080i50;
+        std::vector<StillSlot> stills = std::vector<StillSlot>(kDefaultStillCount);
+        MediaPlayerState media_players[kMediaPlayerCount];
+        uint64_t upload_generation = 0;
+        bool hash_uploads = false;
+    };
+
+    StubState& State()
+    {
+        static StubState state;
+        return state;
+    }
+
+    template <typename Interface>
+    class StubObject : public Interface
+    {
+    public:
+        HRESULT QueryInterface(REFIID, LPVOID* ppv) override
+        {
+            if (ppv == nullptr)
+            {
+                return E_POINTER;
+            }
+
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG AddRef() override
+        {
+            return ++ref_count_;
+        }
+
+        ULONG Release() override
+        {
+            ULONG value = --ref_count_;
+            if (value == 0)
+            {
+                delete this;
+            }
+            return value;
+        }
+
+    private:
+        std::atomic<ULONG> ref_count_{1};
+    };
+
+    // Recycles frame buffers like a driver would, so uploads are not charged for the
+    // kernel faulting in and zeroing fresh pages that the bridge overwrites anyway.
+    class FramePool
+    {
+    public:
+        std::unique_ptr<uint8_t[]> Acquire(size_t size)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<std::unique_ptr<uint8_t[]>>& buffers = free_[size];
+            if (buffers.empty())
+            {
+                return std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+            }
+
+            std::unique_ptr<uint8_t[]> buffer = std::move(buffers.back());
+            buffers.pop_back();
+            return buffer;
+        }
+
+        void Release(size_t size, std::unique_ptr<uint8_t[]> buffer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_[size].push_back(std::move(buffer));
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<size_t, std::vector<std::unique_ptr<uint8_t[]>>> free_;
+    };
+
+    FramePool& Frames()
+    {
+        static FramePool pool;
+        return pool;
+    }
+
+    class StubFrame final : public StubObject<IBMDSwitcherFrame>
+    {
+    public:
+        StubFrame(BMDSwitcherPixelFormat format, uint32_t width, uint32_t height)
+            : format_(format), width_(width), height_(height), bytes_(Frames().Acquire(Size()))
+        {
+        }
+
+        ~StubFrame() override
+        {
+            Frames().Release(Size(), std::move(bytes_));
+        }
+
+        HRESULT GetWidth(uint32_t* width) override
+        {
+            *width = width_;
+            return S_OK;
+        }
+
+        HRESULT GetHeight(uint32_t* height) override
+        {
+            *height = height_;
+            return S_OK;
+        }
+
+        HRESULT GetPixelFormat(BMDSwitcherPixelFormat* format) override
+        {
+            *format = format_;
+            return S_OK;
+        }
+
+        HRESULT GetBytes(void** buffer) override
+        {
+            *buffer = bytes_.get();
+            return S_OK;
+        }
+
+    private:
+        size_t Size() const
+        {
+            return static_cast<size_t>(width_) * height_ * 4;
+        }
+
+        BMDSwitcherPixelFormat format_;
+        uint32_t width_;
+        uint32_t height_;
+        std::unique_ptr<uint8_t[]> bytes_;
+    };
+
+    // Completes locks and transfers synchronously, so benchmarks measure only the
+    // CPU-side work in the bridge.
+    class StubStills final : public StubObject<IBMDSwitcherStills>
+    {
+    public:
+        HRESULT GetCount(uint32_t* count) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            *count = static_cast<uint32_t>(State().stills.size());
+            return S_OK;
+        }
+
+        HRESULT IsValid(uint32_t index, bool* valid) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            if (index >= State().stills.size())
+            {
+                return E_INVALIDARG;
+            }
+
+            *valid = State().stills[index].valid;
+            return S_OK;
+        }
+
+        HRESULT GetName(uint32_t index, CFStringRef* name) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            if (index >= State().stills.size())
+            {
+                return E_INVALIDARG;
+            }
+
+            *name = CFStringCreateWithCString(kCFAllocatorDefault, State().stills[index].name.c_str(), kCFStringEncodingUTF8);
+            return S_OK;
+        }
+
+        HRESULT GetHash(uint32_t index, BMDSwitcherHash* hash) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            if (index >= State().stills.size())
+            {
+                return E_INVALIDARG;
+            }
+
+            *hash = State().stills[index].hash;
+            return S_OK;
+        }
+
+        HRESULT Lock(IBMDSwitcherLockCallback* callback) override
+        {
+            return callback->Obtained();
+        }
+
+        HRESULT Unlock(IBMDSwitcherLockCallback*) override
+        {
+            return S_OK;
+        }
+
+        HRESULT Upload(uint32_t index, CFStringRef name, IBMDSwitcherFrame* frame) override
+        {
+            bool hash_uploads;
+            {
+                std::lock_guard<std::mutex> lock(State().mutex);
+                hash_uploads = State().hash_uploads;
+            }
+
+            BMDSwitcherHash hash{};
+            if (hash_uploads)
+            {
+                uint32_t width = 0;
+                uint32_t height = 0;
+                void* bytes = nullptr;
+                frame->GetWidth(&width);
+                frame->GetHeight(&height);
+                frame->GetBytes(&bytes);
+
+                atem_bridge_detail::Md5 md5;
+                md5.Update(static_cast<const uint8_t*>(bytes), static_cast<size_t>(width) * height * 4);
+                md5.Final(hash.data);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(State().mutex);
+                if (index >= State().stills.size())
+                {
+                    return E_INVALIDARG;
+                }
+
+                StillSlot& slot = State().stills[index];
+                slot.valid = true;
+                slot.name = name != nullptr ? name->value : "";
+                if (hash_uploads)
+                {
+                    slot.hash = hash;
+                }
+                else
+                {
+                    uint64_t generation = ++State().upload_generation;
+                    std::memset(slot.hash.data, 0, sizeof(slot.hash.data));
+                    std::memcpy(slot.hash.data, &generation, sizeof(generation));
+                }
+            }
+
+            std::vector<IBMDSwitcherStillsCallback*> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                callbacks = callbacks_;
+            }
+
+            for (IBMDSwitcherStillsCallback* callback : callbacks)
+            {
+                callback->Notify(bmdSwitcherMediaPoolEventTypeTransferCompleted, frame, static_cast<int32_t>(index));
+            }
+
+            return S_OK;
+        }
+
+        HRESULT CancelTransfer() override
+        {
+            return S_OK;
+        }
+
+        HRESULT AddCallback(IBMDSwitcherStillsCallback* callback) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback->AddRef();
+            callbacks_.push_back(callback);
+            return S_OK;
+        }
+
+        HRESULT RemoveCallback(IBMDSwitcherStillsCallback* callback) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = callbacks_.begin(); it != callbacks_.end(); ++it)
+            {
+                if (*it == callback)
+                {
+                    callbacks_.erase(it);
+                    callback->Release();
+                    return S_OK;
+                }
+            }
+            return E_INVALIDARG;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<IBMDSwitcherStillsCallback*> callbacks_;
+    };
+
+    class StubMediaPool final : public StubObject<IBMDSwitcherMediaPool>
+    {
+    public:
+        HRESULT GetStills(IBMDSwitcherStills** stills) override
+        {
+            *stills = new StubStills();
+            return S_OK;
+        }
+
+        HRESULT CreateFrame(BMDSwitcherPixelFormat format, uint32_t width, uint32_t height, IBMDSwitcherFrame** frame) override
+        {
+            if (width == 0 || height == 0)
+            {
+                return E_INVALIDARG;
+            }
+
+            *frame = new StubFrame(format, width, height);
+            return S_OK;
+        }
+    };
+
+    class StubMediaPlayer final : public StubObject<IBMDSwitcherMediaPlayer>
+    {
+    public:
+        explicit StubMediaPlayer(int32_t index) : index_(index) {}
+
+        HRESULT GetSource(BMDSwitcherMediaPlayerSourceType* type, uint32_t* index) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            *type = State().media_players[index_].type;
+            *index = State().media_players[index_].index;
+            return S_OK;
+        }
+
+        HRESULT SetSource(BMDSwitcherMediaPlayerSourceType type, uint32_t index) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            State().media_players[index_].type = type;
+            State().media_players[index_].index = index;
+            return S_OK;
+        }
+
+    private:
+        int32_t index_;
+    };
+
+    class StubMediaPlayerIterator final : public StubObject<IBMDSwitcherMediaPlayerIterator>
+    {
+    public:
+        HRESULT Next(IBMDSwitcherMediaPlayer** media_player) override
+        {
+            if (next_ >= kMediaPlayerCount)
+            {
+                *media_player = nullptr;
+                return S_FALSE;
+            }
+
+            *media_player = new StubMediaPlayer(next_++);
+            return S_OK;
+        }
+
+    private:
+        int32_t next_ = 0;
+    };
+
+    class StubSwitcher final : public StubObject<IBMDSwitcher>
+    {
+    public:
+        HRESULT QueryInterface(REFIID iid, LPVOID* ppv) override
+        {
+            if (ppv == nullptr)
+            {
+                return E_POINTER;
+            }
+
+            if (SameIid(iid, IID_IBMDSwitcherMediaPool))
+            {
+                *ppv = static_cast<IBMDSwitcherMediaPool*>(new StubMediaPool());
+                return S_OK;
+            }
+
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        HRESULT GetProductName(CFStringRef* name) override
+        {
+            *name = CFStringCreateWithCString(kCFAllocatorDefault, "Stub ATEM", kCFStringEncodingUTF8);
+            return S_OK;
+        }
+
+        HRESULT GetVideoMode(BMDSwitcherVideoMode* mode) override
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            *mode = State().video_mode;
+            return S_OK;
+        }
+
+        HRESULT CreateIterator(REFIID iid, LPVOID* ppv) override
+        {
+            if (ppv == nullptr)
+            {
+                return E_POINTER;
+            }
+
+            if (SameIid(iid, IID_IBMDSwitcherMediaPlayerIterator))
+            {
+                *ppv = static_cast<IBMDSwitcherMediaPlayerIterator*>(new StubMediaPlayerIterator());
+                return S_OK;
+            }
+
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
+    };
+
+    class StubDiscovery final : public StubObject<IBMDSwitcherDiscovery>
+    {
+    public:
+        HRESULT ConnectTo(CFStringRef, IBMDSwitcher** switcher, BMDSwitcherConnectToFailure*) override
+        {
+            *switcher = new StubSwitcher();
+            return S_OK;
+        }
+    };
+
+    IBMDSwitcherDiscovery* CreateStubDiscovery()
+    {
+        return new StubDiscovery();
+    }
+}
+
+CFStringRef CFStringCreateWithCString(CFAllocatorRef, const char* value, CFStringEncoding)
+{
+    return new __CFString(value != nullptr ? value : "");
+}
+
+CFIndex CFStringGetLength(CFStringRef value)
+{
+    return value != nullptr ? static_cast<CFIndex>(value->value.size()) : 0;
+}
+
+CFIndex CFStringGetMaximumSizeForEncoding(CFIndex length, CFStringEncoding)
+{
+    return length;
+}
+
+bool CFStringGetCString(CFStringRef value, char* buffer, CFIndex buffer_size, CFStringEncoding)
+{
+    if (value == nullptr || buffer == nullptr || buffer_size <= static_cast<CFIndex>(value->value.size()))
+    {
+        return false;
+    }
+
+    std::memcpy(buffer, value->value.c_str(), value->value.size() + 1);
+    return true;
+}
+
+CFStringRef __CFStringMakeConstantString(const char* value)
+{
+    // Constant strings live for the process, as they do in CoreFoundation.
+    static std::mutex mutex;
+    static std::map<std::string, CFStringRef> constants;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CFStringRef& entry = constants[value];
+    if (entry == nullptr)
+    {
+        entry = new __CFString(value);
+    }
+    return entry;
+}
+
+CFURLRef CFURLCreateWithFileSystemPath(CFAllocatorRef, CFStringRef path, CFURLPathStyle, bool)
+{
+    return new __CFURL(path != nullptr ? path->value : "");
+}
+
+CFBundleRef CFBundleCreate(CFAllocatorRef, CFURLRef)
+{
+    return new __CFBundle();
+}
+
+void* CFBundleGetFunctionPointerForName(CFBundleRef, CFStringRef name)
+{
+    if (name != nullptr && name->value == kDiscoveryEntryPoint)
+    {
+        return reinterpret_cast<void*>(&CreateStubDiscovery);
+    }
+
+    return nullptr;
+}
+
+void CFRelease(CFTypeRef value)
+{
+    delete static_cast<const StubCFObject*>(value);
+}
+
+void atem_stub_set_video_mode(int32_t video_mode)
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    State().video_mode = static_cast<BMDSwitcherVideoMode>(video_mode);
+}
+
+void atem_stub_set_still_count(int32_t count)
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    State().stills.assign(count > 0 ? static_cast<size_t>(count) : 0, StillSlot());
+    for (size_t i = 0; i < State().stills.size(); ++i)
+    {
+        StillSlot& slot = State().stills[i];
+        slot.valid = true;
+        slot.name = "Still " + std::to_string(i + 1);
+        for (size_t j = 0; j < sizeof(slot.hash.data); ++j)
+        {
+            slot.hash.data[j] = static_cast<uint8_t>(i * 31 + j * 7);
+        }
+    }
+}
+
+void atem_stub_set_hash_uploads(int32_t enabled)
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    State().hash_uploads = enabled != 0;
+}
+
+void atem_stub_set_media_player_source(int32_t media_player, int32_t still_index)
+{
+    if (media_player < 0 || media_player >= kMediaPlayerCount)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(State().mutex);
+    State().media_players[media_player].type = bmdSwitcherMediaPlayerSourceTypeStill;
+    State().media_players[media_player].index = static_cast<uint32_t>(still_index);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "atem_bridge.h"
+
+// Controls for the in-memory switcher behind the stub SDK. Exported from the
+// stub build of atem_bridge so managed benchmarks can drive it as well.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ATEM_BRIDGE_API void atem_stub_set_video_mode(int32_t video_mode);
+
+ATEM_BRIDGE_API void atem_stub_set_still_count(int32_t count);
+
+ATEM_BRIDGE_API void atem_stub_set_media_player_source(int32_t media_player, int32_t still_index);
+
+// By default each upload gives its slot a distinct hash that is unrelated to the
+// pixels, as the SDK's hash is not documented to be any particular digest. Enable
+// this to set it to the MD5 of the uploaded frame instead, which models a switcher
+// whose hash does match a frame file's header.
+ATEM_BRIDGE_API void atem_stub_set_hash_uploads(int32_t enabled);
+
+#ifdef __cplusplus
+}
+#endif